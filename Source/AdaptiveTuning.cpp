@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    AdaptiveTuning.cpp
+    Created: 19 Oct 2026 11:31:08pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "AdaptiveTuning.h"
+
+namespace
+{
+	constexpr int numSets = 1 << 12;
+
+	// 5-limit ratios above the root: 1/1 16/15 9/8 6/5 5/4 4/3 45/32 3/2 8/5 5/3 16/9 15/8,
+	// as their deviation from the tempered interval.
+	constexpr float justOffsets[12] = { 0.0f, 11.731f, 3.910f, 15.641f, -13.686f, -1.955f,
+	                                    -9.776f, 1.955f, 13.686f, -15.641f, -3.910f, -11.731f };
+
+	// How strongly a class present at each interval above a candidate suggests
+	// it as the root: the root itself, then fifth, thirds, sevenths and the rest.
+	constexpr int rootWeights[12] = { 10, 0, 2, 5, 6, 1, 0, 8, 1, 2, 3, 2 };
+
+	int scoreRoot(int set, int candidate) noexcept
+	{
+		int score = 0;
+		for (int bits = set; bits != 0; bits &= bits - 1)
+		{
+			const auto pitchClass = findHighestSetBit((uint32)(bits & -bits));
+			score += rootWeights[(pitchClass - candidate + 12) % 12];
+		}
+		return score;
+	}
+}
+
+//==============================================================================
+struct AdaptiveTuning::Tables
+{
+	Tables()
+	{
+		bestRoot[0] = 0;
+		for (int set = 1; set < numSets; ++set)
+		{
+			int best = 0, bestScore = -1;
+			for (int candidate = 0; candidate < 12; ++candidate)
+			{
+				const auto score = scoreRoot(set, candidate);
+				if (score > bestScore)
+				{
+					best = candidate;
+					bestScore = score;
+				}
+			}
+
+			bestRoot[set] = (uint8)best;
+			bestScores[set] = (uint8)bestScore;
+		}
+	}
+
+	uint8 bestRoot[numSets];
+	uint8 bestScores[numSets];
+};
+
+const AdaptiveTuning::Tables& AdaptiveTuning::getTables()
+{
+	static const Tables tables;
+	return tables;
+}
+
+//==============================================================================
+AdaptiveTuning::AdaptiveTuning()
+{
+	// Built here, on whichever thread creates the first engine, rather than on the audio thread.
+	getTables();
+	reset();
+}
+
+AdaptiveTuning::~AdaptiveTuning()
+{
+}
+
+void AdaptiveTuning::reset() noexcept
+{
+	std::fill(std::begin(counts), std::end(counts), (uint8)0);
+	pitchClassSet = 0;
+	root = 0;
+	reference = 0.0f;
+	computeOffsets();
+}
+
+float AdaptiveTuning::getJustOffset(int semitones) noexcept
+{
+	return justOffsets[((semitones % 12) + 12) % 12];
+}
+
+//==============================================================================
+bool AdaptiveTuning::noteOn(int note) noexcept
+{
+	const auto pitchClass = note % 12;
+	if (counts[pitchClass] == 255)
+		return false;
+
+	if (counts[pitchClass]++ > 0)
+		return false;
+
+	const auto startsPhrase = pitchClassSet == 0;
+	pitchClassSet |= (uint16)(1 << pitchClass);
+	return update(startsPhrase);
+}
+
+bool AdaptiveTuning::noteOff(int note) noexcept
+{
+	const auto pitchClass = note % 12;
+	if (counts[pitchClass] == 0 || --counts[pitchClass] > 0)
+		return false;
+
+	pitchClassSet &= (uint16)~(1 << pitchClass);
+	return update(false);
+}
+
+bool AdaptiveTuning::update(bool startsPhrase) noexcept
+{
+	if (pitchClassSet == 0)
+	{
+		// A rest: start the next phrase from equal temperament again.
+		if (reference == 0.0f)
+			return false;
+
+		reference = 0.0f;
+		computeOffsets();
+		return true;
+	}
+
+	const auto& tables = getTables();
+	const auto candidate = (int)tables.bestRoot[pitchClassSet];
+
+	// Keep the root while it is sounding and close enough to the best.
+	if (candidate == root
+		|| ((pitchClassSet & (1 << root)) != 0 && scoreRoot(pitchClassSet, root) + rootHysteresis >= tables.bestScores[pitchClassSet]))
+		return false;
+
+	// The new root keeps the pitch it had under the old one, within the
+	// drift limit; after a rest there is nothing to stay in tune with.
+	reference = startsPhrase ? 0.0f : jlimit(-driftLimitCents, driftLimitCents, offsets[candidate]);
+	root = candidate;
+	computeOffsets();
+	return true;
+}
+
+void AdaptiveTuning::computeOffsets() noexcept
+{
+	for (int pitchClass = 0; pitchClass < 12; ++pitchClass)
+		offsets[pitchClass] = reference + justOffsets[(pitchClass - root + 12) % 12];
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    AdaptiveTuning.h
+    Created: 19 Oct 2026 11:31:08pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Just intonation that follows the notes being played.
+
+    The sounding notes are kept as a count per pitch class and a 12-bit set
+    of the classes in use. The root is looked up from the set in a table
+    built once for all 4096 sets, by weighting each class by its interval
+    above every candidate root. The current root is kept unless another
+    wins by more than the hysteresis, so a passing note does not move the
+    whole chord. Each pitch class is then tuned to its pure interval above
+    the root.
+
+    Moving the root by pure intervals drifts away from equal temperament
+    over a progression, so the new root keeps the tuning it had under the
+    old one only as far as the drift limit. The reference is recentred
+    whenever all notes have been released.
+
+    A note-on or note-off costs a count update, one table lookup and, when
+    the root or reference moved, twelve offsets; never more, however many
+    notes are held.
+*/
+class AdaptiveTuning
+{
+public:
+	AdaptiveTuning();
+	~AdaptiveTuning();
+
+	void reset() noexcept;
+	void setDriftLimit(float cents) noexcept { driftLimitCents = jmax(0.0f, cents); }
+
+	//==============================================================================
+	/** Return true if the offsets changed. */
+	bool noteOn(int note) noexcept;
+	bool noteOff(int note) noexcept;
+
+	float getOffset(int note) const noexcept { return offsets[note % 12]; }
+	int getRoot() const noexcept { return root; }
+	uint16 getPitchClassSet() const noexcept { return pitchClassSet; }
+
+	/** Deviation of the pure interval from the tempered one, in cents. */
+	static float getJustOffset(int semitones) noexcept;
+
+	static constexpr int rootHysteresis = 3;
+
+private:
+	//==============================================================================
+	struct Tables;
+	static const Tables& getTables();
+
+	bool update(bool startsPhrase) noexcept;
+	void computeOffsets() noexcept;
+
+	uint8 counts[12];
+	uint16 pitchClassSet = 0;
+	int root = 0;
+	float reference = 0.0f;
+	float offsets[12];
+	float driftLimitCents = 20.0f;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdaptiveTuning)
+};
@@ -0,0 +1,474 @@
+/*
+  ==============================================================================
+
+    AutosaveJournal.cpp
+    Created: 20 Oct 2026 1:14:06am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "AutosaveJournal.h"
+
+namespace
+{
+	// File: magic, version and padding, then records of a type, payload
+	// size and payload checksum followed by the payload. Zeros end it.
+	const char fileMagic[4] = { 'M', 'C', 'J', '1' };
+	constexpr int fileVersion = 1;
+	constexpr size_t fileHeaderSize = 16, recordHeaderSize = 16;
+
+	enum RecordType
+	{
+		endRecord = 0,
+		blobRecord,      // hash, content
+		sectionRecord,   // hash of its content, name
+		valuesRecord,    // count, then index and value pairs
+		commitRecord     // generation
+	};
+
+	constexpr size_t minCapacity = 1 << 20;
+	constexpr int staleJournalDays = 30;
+
+	uint64 hashBytes(const void* data, size_t size) noexcept
+	{
+		// FNV-1a; the journal only needs to tell changes and torn writes apart.
+		auto* bytes = static_cast<const uint8*>(data);
+		auto hash = (uint64)0xcbf29ce484222325ULL;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= (uint64)0x100000001b3ULL;
+		}
+
+		return hash;
+	}
+
+	void writeRecord(MemoryOutputStream& out, RecordType type, const MemoryOutputStream& payload)
+	{
+		out.writeInt((int)type);
+		out.writeInt((int)payload.getDataSize());
+		out.writeInt64((int64)hashBytes(payload.getData(), payload.getDataSize()));
+		out.write(payload.getData(), payload.getDataSize());
+	}
+
+	struct OpenJournals
+	{
+		CriticalSection lock;
+		Array<File> files;
+	};
+
+	OpenJournals& getOpenJournals()
+	{
+		static OpenJournals journals;
+		return journals;
+	}
+
+	void deleteStaleJournals(const File& directory)
+	{
+		const auto cutoff = Time::getCurrentTime() - RelativeTime::days(staleJournalDays);
+		const auto& journals = getOpenJournals();
+		const ScopedLock sl(journals.lock);
+
+		for (auto& file : directory.findChildFiles(File::findFiles, false, "*.journal"))
+			if (file.getLastModificationTime() < cutoff && !journals.files.contains(file))
+				file.deleteFile();
+	}
+}
+
+//==============================================================================
+class AutosaveJournal::Writer : public Thread
+{
+public:
+	Writer(const File& fileToUse, const Contents& initial) : Thread("MicroChromo Autosave"), file(fileToUse)
+	{
+		for (auto& section : initial.sections)
+			liveSections[section.first] = { section.first, hashBytes(section.second.getData(), section.second.getSize()), section.second };
+
+		liveValues = initial.values;
+		liveGeneration = initial.generation;
+	}
+
+	~Writer() override
+	{
+		signalThreadShouldExit();
+		notify();
+		stopThread(5000);
+	}
+
+	void push(Batch&& batch)
+	{
+		{
+			const ScopedLock sl(pendingLock);
+			pending.push_back(std::move(batch));
+		}
+		notify();
+	}
+
+	/** Rewrites the file with only the latest contents. */
+	bool compact()
+	{
+		MemoryOutputStream content;
+		content.write(fileMagic, sizeof(fileMagic));
+		content.writeInt(fileVersion);
+		content.writeInt64(0);
+
+		blobsInFile.clear();
+		for (auto& entry : liveSections)
+			writeSection(content, entry.second);
+
+		if (!liveValues.empty())
+		{
+			std::vector<std::pair<int, float>> values(liveValues.begin(), liveValues.end());
+			writeValues(content, values);
+		}
+
+		writeCommit(content, liveGeneration);
+		compactedSize = content.getDataSize();
+
+		auto capacity = minCapacity;
+		while (capacity < compactedSize * 4)
+			capacity *= 2;
+
+		map = nullptr;
+		auto temp = file.getSiblingFile(file.getFileName() + ".tmp");
+		temp.deleteFile();
+
+		{
+			FileOutputStream out(temp);
+			if (out.failedToOpen())
+				return false;
+
+			out.write(content.getData(), content.getDataSize());
+
+			// Zeros past the end mark where the records stop.
+			HeapBlock<char> zeros(1 << 16, true);
+			for (auto remaining = capacity - compactedSize; remaining > 0;)
+			{
+				const auto chunk = jmin(remaining, (size_t)(1 << 16));
+				out.write(zeros, chunk);
+				remaining -= chunk;
+			}
+
+			out.flush();
+			if (out.getStatus().failed())
+				return false;
+		}
+
+		if (!temp.moveFileTo(file))
+			return false;
+
+		map.reset(new MemoryMappedFile(file, MemoryMappedFile::readWrite, false));
+		if (map->getData() == nullptr)
+		{
+			map = nullptr;
+			return false;
+		}
+
+		writePosition = compactedSize;
+		return true;
+	}
+
+	void run() override
+	{
+		while (!threadShouldExit())
+		{
+			wait(-1);
+			flush();
+		}
+
+		flush();
+	}
+
+private:
+	void flush()
+	{
+		std::vector<Batch> batches;
+		{
+			const ScopedLock sl(pendingLock);
+			batches.swap(pending);
+		}
+
+		for (auto& batch : batches)
+			write(batch);
+	}
+
+	void write(Batch& batch)
+	{
+		MemoryOutputStream records;
+
+		for (auto& section : batch.sections)
+		{
+			writeSection(records, section);
+			liveSections[section.name] = std::move(section);
+		}
+
+		if (!batch.values.empty())
+		{
+			writeValues(records, batch.values);
+			for (auto& value : batch.values)
+				liveValues[value.first] = value.second;
+		}
+
+		writeCommit(records, batch.generation);
+		liveGeneration = batch.generation;
+
+		// A full file, or one mostly holding outdated records, is compacted.
+		if (!append(records) || writePosition > jmax(minCapacity / 2, compactedSize * 4))
+			compact();
+	}
+
+	bool append(const MemoryOutputStream& records)
+	{
+		if (map == nullptr || writePosition + records.getDataSize() > map->getSize())
+			return false;
+
+		memcpy(static_cast<char*>(map->getData()) + writePosition, records.getData(), records.getDataSize());
+		writePosition += records.getDataSize();
+		return true;
+	}
+
+	void writeSection(MemoryOutputStream& out, const Section& section)
+	{
+		// Sections with the same content, e.g. clones' states, share one blob.
+		if (blobsInFile.insert(section.hash).second)
+		{
+			MemoryOutputStream blob;
+			blob.writeInt64((int64)section.hash);
+			blob.write(section.data.getData(), section.data.getSize());
+			writeRecord(out, blobRecord, blob);
+		}
+
+		MemoryOutputStream payload;
+		payload.writeInt64((int64)section.hash);
+		payload.write(section.name.toRawUTF8(), section.name.getNumBytesAsUTF8());
+		writeRecord(out, sectionRecord, payload);
+	}
+
+	void writeValues(MemoryOutputStream& out, const std::vector<std::pair<int, float>>& values)
+	{
+		MemoryOutputStream payload;
+		payload.writeInt((int)values.size());
+		for (auto& value : values)
+		{
+			payload.writeInt(value.first);
+			payload.writeFloat(value.second);
+		}
+		writeRecord(out, valuesRecord, payload);
+	}
+
+	void writeCommit(MemoryOutputStream& out, int64 batchGeneration)
+	{
+		MemoryOutputStream payload;
+		payload.writeInt64(batchGeneration);
+		writeRecord(out, commitRecord, payload);
+	}
+
+	const File file;
+	std::unique_ptr<MemoryMappedFile> map;
+	size_t writePosition = 0, compactedSize = 0;
+
+	std::map<String, Section> liveSections;
+	std::map<int, float> liveValues;
+	int64 liveGeneration = 0;
+	std::set<uint64> blobsInFile;
+
+	CriticalSection pendingLock;
+	std::vector<Batch> pending;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Writer)
+};
+
+//==============================================================================
+AutosaveJournal::AutosaveJournal(std::function<void()> captureCallback)
+	: onCapture(std::move(captureCallback))
+{
+}
+
+AutosaveJournal::~AutosaveJournal()
+{
+	close(false);
+}
+
+File AutosaveJournal::getDefaultDirectory()
+{
+	return File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("MicroChromo").getChildFile("Autosave");
+}
+
+bool AutosaveJournal::open(const File& file)
+{
+	if (isOpen())
+		close(false);
+
+	{
+		auto& journals = getOpenJournals();
+		const ScopedLock sl(journals.lock);
+		if (journals.files.contains(file))
+			return false;
+		journals.files.add(file);
+	}
+
+	file.getParentDirectory().createDirectory();
+	deleteStaleJournals(file.getParentDirectory());
+
+	if (!file.existsAsFile() || !read(file))
+		recovered = {};
+
+	generation = recovered.generation;
+	sectionHashes.clear();
+	for (auto& section : recovered.sections)
+		sectionHashes[section.first] = hashBytes(section.second.getData(), section.second.getSize());
+
+	lastValues.clear();
+	batch = {};
+	journalFile = file;
+
+	// Start the file over with what was recovered.
+	writer.reset(new Writer(file, recovered));
+	if (!writer->compact())
+	{
+		writer = nullptr;
+		close(true);
+		return false;
+	}
+
+	writer->startThread(2);
+	startTimer(snapshotIntervalMs);
+	return true;
+}
+
+void AutosaveJournal::close(bool keepFile)
+{
+	stopTimer();
+
+	if (journalFile == File())
+		return;
+
+	// The writer finishes the queued batches first; an uncommitted one is dropped.
+	batch = {};
+	writer = nullptr;
+
+	if (!keepFile)
+		journalFile.deleteFile();
+
+	{
+		auto& journals = getOpenJournals();
+		const ScopedLock sl(journals.lock);
+		journals.files.removeAllInstancesOf(journalFile);
+	}
+
+	journalFile = File();
+}
+
+//==============================================================================
+void AutosaveJournal::writeSection(const String& name, const MemoryBlock& data)
+{
+	const auto hash = hashBytes(data.getData(), data.getSize());
+
+	const auto known = sectionHashes.find(name);
+	if (known != sectionHashes.end() && known->second == hash)
+		return;
+
+	sectionHashes[name] = hash;
+	batch.sections.push_back({ name, hash, data });
+}
+
+void AutosaveJournal::writeValues(const Array<float>& values)
+{
+	for (int i = 0; i < values.size(); ++i)
+		if (i >= lastValues.size() || lastValues.getUnchecked(i) != values.getUnchecked(i))
+			batch.values.push_back({ i, values.getUnchecked(i) });
+
+	lastValues = values;
+}
+
+void AutosaveJournal::commit()
+{
+	if (writer == nullptr || (batch.sections.empty() && batch.values.empty()))
+	{
+		batch = {};
+		return;
+	}
+
+	batch.generation = generation.load() + 1;
+	generation = batch.generation;
+	writer->push(std::move(batch));
+	batch = {};
+}
+
+void AutosaveJournal::timerCallback()
+{
+	if (onCapture != nullptr)
+		onCapture();
+}
+
+//==============================================================================
+bool AutosaveJournal::read(const File& file)
+{
+	recovered = {};
+
+	MemoryMappedFile map(file, MemoryMappedFile::readOnly, false);
+	const auto* data = static_cast<const uint8*>(map.getData());
+	const auto size = map.getSize();
+
+	if (data == nullptr || size < fileHeaderSize || memcmp(data, fileMagic, sizeof(fileMagic)) != 0
+		|| (int)ByteOrder::littleEndianInt(data + 4) != fileVersion)
+		return false;
+
+	// Sections only count once their batch has been committed.
+	std::map<uint64, Range<size_t>> blobs;
+	std::map<String, uint64> sections, committedSections;
+	std::map<int, float> values, committedValues;
+
+	for (auto position = fileHeaderSize; position + recordHeaderSize <= size;)
+	{
+		const auto type = ByteOrder::littleEndianInt(data + position);
+		const auto payloadSize = (size_t)ByteOrder::littleEndianInt(data + position + 4);
+		const auto checksum = ByteOrder::littleEndianInt64(data + position + 8);
+		const auto* payload = data + position + recordHeaderSize;
+
+		if (type == endRecord || payloadSize > size - position - recordHeaderSize
+			|| hashBytes(payload, payloadSize) != checksum)
+			break;
+
+		if (type == blobRecord && payloadSize >= 8)
+		{
+			const auto offset = position + recordHeaderSize + 8;
+			blobs[ByteOrder::littleEndianInt64(payload)] = { offset, offset + payloadSize - 8 };
+		}
+		else if (type == sectionRecord && payloadSize >= 8)
+		{
+			sections[String::fromUTF8((const char*)payload + 8, (int)payloadSize - 8)] = ByteOrder::littleEndianInt64(payload);
+		}
+		else if (type == valuesRecord && payloadSize >= 4)
+		{
+			const auto count = (size_t)ByteOrder::littleEndianInt(payload);
+			for (size_t i = 0; i < count && 4 + (i + 1) * 8 <= payloadSize; ++i)
+			{
+				const auto bits = ByteOrder::littleEndianInt(payload + 4 + i * 8 + 4);
+				float value;
+				memcpy(&value, &bits, sizeof(value));
+				values[(int)ByteOrder::littleEndianInt(payload + 4 + i * 8)] = value;
+			}
+		}
+		else if (type == commitRecord && payloadSize >= 8)
+		{
+			committedSections = sections;
+			committedValues = values;
+			recovered.generation = (int64)ByteOrder::littleEndianInt64(payload);
+		}
+
+		position += recordHeaderSize + payloadSize;
+	}
+
+	for (auto& section : committedSections)
+	{
+		const auto blob = blobs.find(section.second);
+		if (blob != blobs.end())
+			recovered.sections[section.first] = MemoryBlock(data + blob->second.getStart(), blob->second.getLength());
+	}
+
+	recovered.values = committedValues;
+	return true;
+}
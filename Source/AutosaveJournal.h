@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    AutosaveJournal.h
+    Created: 20 Oct 2026 1:14:06am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <map>
+#include <set>
+
+//==============================================================================
+/**
+    A journal of the processor's state on disk, appended to in the
+    background, so a crash of the host, or of a plugin inside it, loses no
+    more than the last few seconds.
+
+    A timer on the message thread calls back to capture the state as named
+    sections and a list of parameter values. Sections are hashed, and only
+    those whose hash changed are queued, with only the changed parameter
+    values. commit() closes the batch. A writer thread at low priority
+    appends each batch to the file through a memory mapping, storing every
+    distinct section content once, so that clones with the same plugin
+    state share it. The OS keeps writing the mapped pages after the process
+    dies.
+
+    Every record carries a checksum and every batch ends with a commit
+    record, so a torn write at the end is ignored when reading the file
+    back. When the file is full, or mostly holds outdated records, the
+    latest contents are written to a new file which then replaces it.
+
+    open() reads what a previous session left in the file, to be applied by
+    the owner, and carries on from there. close() deletes the file unless
+    asked to keep it, so only a session that never closed leaves one behind.
+*/
+class AutosaveJournal : private Timer
+{
+public:
+	AutosaveJournal(std::function<void()> captureCallback);
+	~AutosaveJournal();
+
+	//==============================================================================
+	/** Recovers what the file holds and starts autosaving to it; false if another instance has it open. */
+	bool open(const File& file);
+	void close(bool keepFile);
+	bool isOpen() const noexcept { return writer != nullptr; }
+
+	//==============================================================================
+	/** Message thread, from the capture callback. */
+	void writeSection(const String& name, const MemoryBlock& data);
+	void writeValues(const Array<float>& values);
+	void commit();
+
+	/** The last committed batch, counting on from the file's when it was recovered. */
+	int64 getGeneration() const noexcept { return generation.load(); }
+
+	//==============================================================================
+	struct Contents
+	{
+		std::map<String, MemoryBlock> sections;
+		std::map<int, float> values;
+		int64 generation = 0;
+	};
+
+	/** What open() read from the file, up to the last complete batch. */
+	const Contents& getRecovered() const noexcept { return recovered; }
+	void clearRecovered() { recovered = {}; }
+
+	static File getDefaultDirectory();
+	static constexpr int snapshotIntervalMs = 2000;
+
+private:
+	//==============================================================================
+	struct Section
+	{
+		String name;
+		uint64 hash = 0;
+		MemoryBlock data;
+	};
+
+	struct Batch
+	{
+		std::vector<Section> sections;
+		std::vector<std::pair<int, float>> values;
+		int64 generation = 0;
+	};
+
+	class Writer;
+
+	void timerCallback() override;
+	bool read(const File& file);
+
+	std::function<void()> onCapture;
+	std::unique_ptr<Writer> writer;
+	File journalFile;
+	Contents recovered;
+
+	// Message thread: what has been queued so far, to only queue changes.
+	std::map<String, uint64> sectionHashes;
+	Array<float> lastValues;
+	Batch batch;
+	std::atomic<int64> generation{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutosaveJournal)
+};
@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 19 Oct 2026 9:05:44pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include "PluginProcessor.h"
+#include "MessageThread.h"
+#include <iostream>
+
+const char* const BatchRenderer::commandLineFlag = "--render";
+
+namespace
+{
+	CriticalSection outputLock;
+
+	void printLine(const String& line)
+	{
+		const ScopedLock sl(outputLock);
+		std::cout << line << std::endl;
+	}
+
+	String getOptionValue(const StringArray& args, const String& name)
+	{
+		const auto index = args.indexOf(name);
+		return index >= 0 ? args[index + 1] : String();
+	}
+}
+
+//==============================================================================
+class BatchRenderer::RenderJob : public ThreadPoolJob
+{
+public:
+	RenderJob(const BatchRenderer& o, const Job& j, Result& r)
+		: ThreadPoolJob(j.outputFile.getFileName()), owner(o), job(j), result(r)
+	{
+	}
+
+	JobStatus runJob() override
+	{
+		result = owner.render(job);
+
+		if (result.succeeded)
+			printLine(job.outputFile.getFullPathName() + ": " + String(result.audioSeconds, 1) + " s in "
+				+ String(result.wallSeconds, 2) + " s (" + String(result.audioSeconds / jmax(1.0e-6, result.wallSeconds), 1) + "x)");
+		else
+			printLine(job.outputFile.getFullPathName() + ": failed, " + result.error);
+
+		return jobHasFinished;
+	}
+
+private:
+	const BatchRenderer& owner;
+	const Job job;
+	Result& result;
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer(const Options& o) : options(o)
+{
+	audioFormats.registerBasicFormats();
+}
+
+BatchRenderer::~BatchRenderer()
+{
+}
+
+bool BatchRenderer::run(const Array<Job>& jobs)
+{
+	const auto numThreads = options.numThreads > 0 ? options.numThreads : SystemStats::getNumCpus();
+	std::vector<Result> results((size_t)jobs.size());
+
+	const auto startTime = Time::getMillisecondCounterHiRes();
+	{
+		ThreadPool pool(numThreads);
+		for (int i = 0; i < jobs.size(); ++i)
+			pool.addJob(new RenderJob(*this, jobs.getReference(i), results[(size_t)i]), true);
+
+		while (pool.getNumJobs() > 0)
+			Thread::sleep(50);
+	}
+	const auto wallSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+	int numFailed = 0;
+	double audioSeconds = 0.0;
+	for (auto& result : results)
+	{
+		audioSeconds += result.audioSeconds;
+		if (!result.succeeded)
+			++numFailed;
+	}
+
+	printLine(String(jobs.size() - numFailed) + " of " + String(jobs.size()) + " jobs rendered on "
+		+ String(numThreads) + " threads: " + String(audioSeconds, 1) + " s of audio in " + String(wallSeconds, 2)
+		+ " s, real-time factor " + String(audioSeconds / jmax(1.0e-6, wallSeconds), 1));
+
+	return numFailed == 0;
+}
+
+//==============================================================================
+BatchRenderer::Result BatchRenderer::render(const Job& job) const
+{
+	Result result;
+	const auto startTime = Time::getMillisecondCounterHiRes();
+
+	MidiFile midiFile;
+	{
+		FileInputStream in(job.midiFile);
+		if (!in.openedOk() || !midiFile.readFrom(in))
+		{
+			result.error = "cannot read " + job.midiFile.getFullPathName();
+			return result;
+		}
+	}
+
+	midiFile.convertTimestampTicksToSeconds();
+	MidiMessageSequence sequence;
+	for (int track = 0; track < midiFile.getNumTracks(); ++track)
+		sequence.addSequence(*midiFile.getTrack(track), 0.0);
+	sequence.sort();
+
+	Array<float> tuning;
+	if (job.tuningFile != File())
+		tuning = MicroChromoAudioProcessor::loadTuningFile(job.tuningFile);
+
+	MemoryBlock preset;
+	if (job.presetFile != File() && !job.presetFile.loadFileAsData(preset))
+	{
+		result.error = "cannot read " + job.presetFile.getFullPathName();
+		return result;
+	}
+
+	// Plugins are created, loaded and prepared on the message thread.
+	std::unique_ptr<MicroChromoAudioProcessor> processor;
+	runOnMessageThread([&]
+	{
+		processor.reset(new MicroChromoAudioProcessor());
+		processor->setAutosaveEnabled(false);
+		processor->setNonRealtime(true);
+
+		// Nothing edits the graph during a render.
+		processor->setTopologyFrozen(true);
+
+		processor->setPlayConfigDetails(0, 2, options.sampleRate, options.blockSize);
+		processor->prepareToPlay(options.sampleRate, options.blockSize);
+
+		if (preset.getSize() > 0)
+			processor->setStateInformation(preset.getData(), (int)preset.getSize());
+
+		if (!tuning.isEmpty())
+			processor->setNoteOffsets(tuning);
+
+		// The backends only know their latency once prepared, and the
+		// processor would otherwise report it asynchronously.
+		processor->updateLatencyCompensation();
+	});
+
+	job.outputFile.getParentDirectory().createDirectory();
+	job.outputFile.deleteFile();
+
+	auto* format = audioFormats.findFormatForFileExtension(job.outputFile.getFileExtension());
+	if (format == nullptr)
+		format = audioFormats.getDefaultFormat();
+
+	std::unique_ptr<AudioFormatWriter> writer;
+	std::unique_ptr<FileOutputStream> out(job.outputFile.createOutputStream());
+	if (out != nullptr && out->openedOk())
+	{
+		writer.reset(format->createWriterFor(out.get(), options.sampleRate, 2, 24, {}, 0));
+		if (writer != nullptr)
+			out.release();
+	}
+
+	if (writer == nullptr)
+	{
+		runOnMessageThread([&] { processor = nullptr; });
+		result.error = "cannot write " + job.outputFile.getFullPathName();
+		return result;
+	}
+
+	// The first latency samples are dropped so the file lines up with the MIDI.
+	const auto latency = processor->getLatencySamples();
+	const auto lengthSamples = (int64)((sequence.getEndTime() + options.tailSeconds) * options.sampleRate);
+	const auto totalSamples = lengthSamples + latency;
+
+	AudioBuffer<float> buffer(2, options.blockSize);
+	MidiBuffer midi;
+	int nextEvent = 0;
+
+	for (int64 position = 0; position < totalSamples; position += options.blockSize)
+	{
+		const auto numSamples = (int)jmin((int64)options.blockSize, totalSamples - position);
+		const auto blockEnd = (double)(position + numSamples) / options.sampleRate;
+
+		midi.clear();
+		for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+		{
+			const auto& message = sequence.getEventPointer(nextEvent)->message;
+			if (message.getTimeStamp() >= blockEnd)
+				break;
+
+			if (!message.isMetaEvent())
+				midi.addEvent(message, jlimit(0, numSamples - 1, (int)(message.getTimeStamp() * options.sampleRate - (double)position)));
+		}
+
+		AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, numSamples);
+		block.clear();
+		processor->processBlock(block, midi);
+
+		const auto skip = (int)jlimit((int64)0, (int64)numSamples, (int64)latency - position);
+		if (skip < numSamples)
+			writer->writeFromAudioSampleBuffer(block, skip, numSamples - skip);
+	}
+
+	writer = nullptr;
+	runOnMessageThread([&] { processor = nullptr; });
+
+	result.succeeded = true;
+	result.audioSeconds = (double)lengthSamples / options.sampleRate;
+	result.wallSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+	return result;
+}
+
+//==============================================================================
+Array<BatchRenderer::Job> BatchRenderer::loadJobList(const File& file, String& error)
+{
+	Array<Job> jobs;
+	var list;
+
+	const auto parseResult = JSON::parse(file.loadFileAsString(), list);
+	if (parseResult.failed() || !list.isArray())
+	{
+		error = "cannot parse " + file.getFullPathName() + ": " + parseResult.getErrorMessage();
+		return {};
+	}
+
+	const auto folder = file.getParentDirectory();
+	auto resolve = [&folder](const var& path) { return path.toString().isEmpty() ? File() : folder.getChildFile(path.toString()); };
+
+	for (auto& entry : *list.getArray())
+	{
+		Job job;
+		job.midiFile = resolve(entry["midi"]);
+		job.tuningFile = resolve(entry["tuning"]);
+		job.presetFile = resolve(entry["preset"]);
+		job.outputFile = resolve(entry["output"]);
+
+		if (job.midiFile == File() || job.outputFile == File())
+		{
+			error = "every job needs \"midi\" and \"output\"";
+			return {};
+		}
+
+		jobs.add(job);
+	}
+
+	return jobs;
+}
+
+int BatchRenderer::runFromCommandLine(const String& commandLine)
+{
+	auto args = StringArray::fromTokens(commandLine, true);
+	for (auto& arg : args)
+		arg = arg.unquoted();
+
+	const auto jobFile = File::getCurrentWorkingDirectory().getChildFile(getOptionValue(args, commandLineFlag));
+
+	String error;
+	auto jobs = loadJobList(jobFile, error);
+	if (error.isNotEmpty())
+	{
+		printLine(error);
+		return 1;
+	}
+
+	Options options;
+	if (args.contains("--rate"))
+		options.sampleRate = jmax(8000.0, getOptionValue(args, "--rate").getDoubleValue());
+	if (args.contains("--block"))
+		options.blockSize = jlimit(16, 8192, getOptionValue(args, "--block").getIntValue());
+	if (args.contains("--threads"))
+		options.numThreads = jmax(1, getOptionValue(args, "--threads").getIntValue());
+	if (args.contains("--tail"))
+		options.tailSeconds = jmax(0.0, getOptionValue(args, "--tail").getDoubleValue());
+
+	BatchRenderer renderer(options);
+	return renderer.run(jobs) ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 19 Oct 2026 9:05:44pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Renders a list of MIDI files offline, each with its own tuning and preset,
+    into audio files.
+
+    Jobs run on a thread pool, one MicroChromoAudioProcessor per job. Setting
+    up a processor happens on the message thread, as hosted plugins expect;
+    the rendering itself stays on the worker and streams blocks straight to
+    the writer. At the end the aggregate speed is printed as a real-time
+    factor, i.e. seconds of audio per second of wall-clock time.
+
+    The job list is a JSON array of objects with "midi", "output" and
+    optionally "tuning" and "preset" paths, relative to the list's folder.
+    A tuning file holds up to 128 offsets in cents, one per MIDI note, and a
+    preset is a saved plugin state.
+*/
+class BatchRenderer
+{
+public:
+	struct Job
+	{
+		File midiFile, tuningFile, presetFile, outputFile;
+	};
+
+	struct Options
+	{
+		double sampleRate = 48000.0;
+		int blockSize = 512;
+		int numThreads = 0;
+		double tailSeconds = 2.0;
+	};
+
+	//==============================================================================
+	BatchRenderer(const Options& options);
+	~BatchRenderer();
+
+	/** Renders every job, printing a line per job and a summary. Returns true if all succeeded. */
+	bool run(const Array<Job>& jobs);
+
+	static Array<Job> loadJobList(const File& file, String& error);
+
+	/** Handles "--render <jobs.json> [--rate r] [--block n] [--threads n] [--tail s]"; returns the exit code. */
+	static int runFromCommandLine(const String& commandLine);
+
+	static const char* const commandLineFlag;
+
+private:
+	//==============================================================================
+	struct Result
+	{
+		bool succeeded = false;
+		String error;
+		double audioSeconds = 0.0, wallSeconds = 0.0;
+	};
+
+	class RenderJob;
+
+	Result render(const Job& job) const;
+
+	Options options;
+	AudioFormatManager audioFormats;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchRenderer)
+};
@@ -0,0 +1,1333 @@
+/*
+  ==============================================================================
+
+    Benchmarks.cpp
+    Created: 20 Oct 2026 2:31:09am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "PluginProcessor.h"
+#include "MessageThread.h"
+#include "MidiRouter.h"
+#include "ReferenceSynth.h"
+#include "SandboxBridge.h"
+#include <iostream>
+
+const char* const Benchmarks::commandLineFlag = "--benchmark";
+const char* const Benchmarks::category = "Benchmarks";
+
+namespace
+{
+	struct Timing
+	{
+		double medianMicros = 0.0, worstMicros = 0.0;
+
+		String toString() const
+		{
+			return "median " + String(medianMicros, 1) + " us, worst " + String(worstMicros, 1) + " us";
+		}
+	};
+
+	Timing summarise(std::vector<double> micros)
+	{
+		if (micros.empty())
+			return {};
+
+		std::sort(micros.begin(), micros.end());
+		return { micros[micros.size() / 2], micros.back() };
+	}
+
+	double microsSince(int64 startTicks)
+	{
+		return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+	}
+
+	/** Calls fn the given number of times and times each call. */
+	template <typename Function>
+	Timing measure(int iterations, Function&& fn)
+	{
+		std::vector<double> micros((size_t)jmax(1, iterations));
+		for (auto& m : micros)
+		{
+			const auto startTicks = Time::getHighResolutionTicks();
+			fn();
+			m = microsSince(startTicks);
+		}
+
+		return summarise(std::move(micros));
+	}
+
+	/** Waits for the shared plugin list to load, and returns the first instrument in it. */
+	bool findFirstInstrument(PluginDatabase& database, PluginDescription& result)
+	{
+		runOnMessageThread([&] { database.loadAsync(); });
+
+		const auto start = Time::getMillisecondCounterHiRes();
+		while (!database.isLoaded() && Time::getMillisecondCounterHiRes() - start < 30000.0)
+			Thread::sleep(1);
+
+		bool found = false;
+		runOnMessageThread([&]
+		{
+			if (!database.isLoaded())
+				return;
+
+			auto& list = database.getKnownPluginList();
+			for (int i = 0; i < list.getNumTypes() && !found; ++i)
+			{
+				if (auto* type = list.getType(i))
+				{
+					if (type->isInstrument)
+					{
+						result = *type;
+						found = true;
+					}
+				}
+			}
+		});
+
+		return found;
+	}
+
+	class BenchmarkRunner : public UnitTestRunner
+	{
+	public:
+		BenchmarkRunner()
+		{
+			setAssertOnFailure(false);
+		}
+
+		void logMessage(const String& message) override
+		{
+			std::cout << message << std::endl;
+		}
+	};
+
+	//==============================================================================
+	class EditorOpenBenchmark : public UnitTest
+	{
+	public:
+		EditorOpenBenchmark() : UnitTest("Editor open", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			beginTest("Opening the editor while the plugin list loads");
+
+			std::unique_ptr<MicroChromoAudioProcessor> processor;
+			runOnMessageThread([&] { processor.reset(new MicroChromoAudioProcessor()); });
+
+			// The first editor finds the list unloaded and starts loading it;
+			// the later ones may find it loaded and fill their list box.
+			Timing first, later;
+			runOnMessageThread([&]
+			{
+				auto open = [&processor] { std::unique_ptr<AudioProcessorEditor> editor(processor->createEditor()); };
+				first = measure(1, open);
+				later = measure(20, open);
+			});
+
+			SharedResourcePointer<PluginDatabase> database;
+			const auto loadStart = Time::getMillisecondCounterHiRes();
+			while (!database->isLoaded() && Time::getMillisecondCounterHiRes() - loadStart < 30000.0)
+				Thread::sleep(1);
+
+			const auto loadMs = Time::getMillisecondCounterHiRes() - loadStart;
+			int numPlugins = 0;
+			runOnMessageThread([&] { numPlugins = database->getKnownPluginList().getNumTypes(); });
+
+			logMessage("First open: " + String(first.worstMicros * 0.001, 2) + " ms");
+			logMessage("Later opens: " + later.toString());
+			logMessage("Plugin list ready " + String(loadMs, 1) + " ms after the first open, " + String(numPlugins) + " plugins");
+
+			expect(first.worstMicros < openBudgetMs * 1000.0, "The first editor took longer than " + String(openBudgetMs) + " ms");
+			expect(later.worstMicros < openBudgetMs * 1000.0, "An editor took longer than " + String(openBudgetMs) + " ms");
+
+			runOnMessageThread([&] { processor = nullptr; });
+		}
+
+	private:
+		// Past this, a host visibly hangs while the window opens.
+		static constexpr double openBudgetMs = 100.0;
+	};
+
+	static EditorOpenBenchmark editorOpenBenchmark;
+
+	//==============================================================================
+	class MidiThroughputBenchmark : public UnitTest
+	{
+	public:
+		MidiThroughputBenchmark() : UnitTest("MIDI throughput", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			for (auto eventsPerSecond : { 10000, 100000 })
+			{
+				beginTest(String(eventsPerSecond) + " events per second of notes, CC and aftertouch");
+				runStorm(eventsPerSecond);
+			}
+		}
+
+	private:
+		void runStorm(int eventsPerSecond)
+		{
+			MidiEventPool pool;
+			MidiRouter router(pool);
+			pool.prepare(numInstances, blockSize);
+			router.prepare(numInstances, sampleRate, blockSize);
+
+			// A different offset for every pitch class, so the notes spread over the instances.
+			Array<float> offsets;
+			for (int note = 0; note < 128; ++note)
+				offsets.add((float)(note % 12) * 7.0f - 40.0f);
+			router.setNoteOffsets(offsets);
+
+			std::vector<MidiBuffer> outputs((size_t)numInstances);
+			for (auto& output : outputs)
+				output.ensureSize((size_t)pool.getByteCapacity() + 6 * (size_t)pool.getEventCapacity());
+
+			// One second of input, built up front. Every 32nd event starts a
+			// note and every 32nd ends the one started four notes earlier; the
+			// rest are controllers, channel pressure and polyphonic aftertouch.
+			const auto numBlocks = roundToInt(sampleRate / blockSize);
+			std::vector<MidiBuffer> input((size_t)numBlocks);
+			const auto samplesPerEvent = sampleRate / eventsPerSecond;
+			int numEvents = 0;
+
+			for (int k = 0;; ++k)
+			{
+				const auto position = (int)(k * samplesPerEvent);
+				const auto block = position / blockSize;
+				if (block >= numBlocks)
+					break;
+
+				const auto chord = k / 32;
+				const auto lastNote = 48 + (chord * 7) % 36;
+				const auto value = k % 128;
+				MidiMessage message;
+
+				switch (k % 32)
+				{
+					case 0:  message = MidiMessage::noteOn(1, lastNote, (uint8)(40 + value % 80)); break;
+					case 16: message = MidiMessage::noteOff(1, 48 + ((chord + 32) * 7) % 36); break;
+					default:
+						switch (k % 4)
+						{
+							case 0:  message = MidiMessage::channelPressureChange(1, value); break;
+							case 1:  message = MidiMessage::aftertouchChange(1, lastNote, value); break;
+							case 2:  message = MidiMessage::controllerEvent(1, 1, value); break;
+							default: message = MidiMessage::controllerEvent(1, 74, value); break;
+						}
+						break;
+				}
+
+				input[(size_t)block].addEvent(message, position % blockSize);
+				++numEvents;
+			}
+
+			auto renderBlock = [&, block = 0]() mutable
+			{
+				router.process(input[(size_t)block], blockSize);
+				for (int i = 0; i < numInstances; ++i)
+				{
+					outputs[(size_t)i].clear();
+					pool.renderView(i, outputs[(size_t)i]);
+				}
+
+				block = (block + 1) % numBlocks;
+			};
+
+			// A first pass to warm the caches, then ten seconds of blocks.
+			for (int i = 0; i < numBlocks; ++i)
+				renderBlock();
+
+			const auto timing = measure(10 * numBlocks, renderBlock);
+			const auto blockMicros = blockSize / sampleRate * 1.0e6;
+
+			logMessage(String(numEvents) + " events over " + String(numInstances) + " instances, "
+				+ String(blockSize) + " samples per block: " + timing.toString()
+				+ " (" + String(timing.medianMicros / blockMicros * 100.0, 2) + "% of the block)");
+			logMessage("Dropped events: " + String(pool.getNumDroppedEvents()));
+
+			expectEquals(pool.getNumDroppedEvents(), 0, "The pool dropped events");
+			expect(timing.medianMicros < blockMicros * budgetShare, "Routing took more than "
+				+ String(budgetShare * 100.0) + "% of the block");
+		}
+
+		static constexpr int numInstances = 8, blockSize = 64;
+		static constexpr double sampleRate = 48000.0;
+
+		// Routing is bookkeeping; the instances need the rest of the block.
+		static constexpr double budgetShare = 0.05;
+	};
+
+	static MidiThroughputBenchmark midiThroughputBenchmark;
+
+	//==============================================================================
+	class SandboxRoundTripBenchmark : public UnitTest
+	{
+	public:
+		SandboxRoundTripBenchmark() : UnitTest("Sandbox round trip", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			beginTest("The same instrument in process and in the bridge");
+
+			SharedResourcePointer<PluginDatabase> database;
+			PluginDescription description;
+			if (!findFirstInstrument(*database, description))
+			{
+				logMessage("Skipped: there is no instrument in the plugin list");
+				return;
+			}
+
+			// This executable doubles as the bridge.
+			String error;
+			std::unique_ptr<AudioPluginInstance> local;
+			std::unique_ptr<SandboxedProcessor> sandboxed;
+			runOnMessageThread([&]
+			{
+				local = database->getFormatManager().createPluginInstance(description, sampleRate, blockSize, error);
+				sandboxed.reset(new SandboxedProcessor(description, File::getSpecialLocation(File::currentExecutableFile)));
+
+				for (auto* processor : { (AudioProcessor*)local.get(), (AudioProcessor*)sandboxed.get() })
+				{
+					if (processor != nullptr)
+					{
+						processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+						processor->prepareToPlay(sampleRate, blockSize);
+					}
+				}
+			});
+
+			expect(local != nullptr, "Could not load " + description.name + ": " + error);
+			expect(sandboxed->isConnected(), "Could not start the bridge: " + sandboxed->getLastError());
+
+			if (local != nullptr && sandboxed->isConnected())
+				compare(*local, *sandboxed, description.name);
+
+			runOnMessageThread([&]
+			{
+				if (local != nullptr)
+					local->releaseResources();
+				sandboxed->releaseResources();
+
+				local = nullptr;
+				sandboxed = nullptr;
+			});
+		}
+
+	private:
+		void compare(AudioPluginInstance& local, SandboxedProcessor& sandboxed, const String& name)
+		{
+			AudioBuffer<float> localBuffer(jmax(2, local.getTotalNumInputChannels(), local.getTotalNumOutputChannels()), blockSize);
+			AudioBuffer<float> sandboxedBuffer(2, blockSize);
+			MidiBuffer localMidi, sandboxedMidi, chord;
+
+			for (auto note : { 48, 55, 64, 71 })
+				chord.addEvent(MidiMessage::noteOn(1, note, (uint8)100), 0);
+
+			// The bridge answers only once it has loaded and prepared the plugin.
+			const auto start = Time::getMillisecondCounterHiRes();
+			while (sandboxed.getLastRoundTripMicros() <= 0.0 && Time::getMillisecondCounterHiRes() - start < 30000.0)
+			{
+				sandboxedBuffer.clear();
+				sandboxedMidi = chord;
+				sandboxed.processBlock(sandboxedBuffer, sandboxedMidi);
+				Thread::sleep(1);
+			}
+
+			expect(sandboxed.getLastRoundTripMicros() > 0.0, "The bridge never answered");
+			if (sandboxed.getLastRoundTripMicros() <= 0.0)
+				return;
+
+			const auto missedBefore = sandboxed.getNumMissedBlocks();
+
+			localMidi = chord;
+			local.processBlock(localBuffer, localMidi);
+
+			// Both render the same held chord, so the difference is the transport.
+			const auto inProcess = measure(numBlocks, [&]
+			{
+				localMidi.clear();
+				local.processBlock(localBuffer, localMidi);
+			});
+
+			const auto bridged = measure(numBlocks, [&]
+			{
+				sandboxedMidi.clear();
+				sandboxed.processBlock(sandboxedBuffer, sandboxedMidi);
+			});
+
+			const auto overhead = bridged.medianMicros - inProcess.medianMicros;
+			const auto missed = sandboxed.getNumMissedBlocks() - missedBefore;
+
+			logMessage(name + ", " + String(blockSize) + " samples per block");
+			logMessage("In process: " + inProcess.toString());
+			logMessage("In the bridge: " + bridged.toString() + ", last round trip "
+				+ String(sandboxed.getLastRoundTripMicros(), 1) + " us, worst " + String(sandboxed.getMaxRoundTripMicros(), 1) + " us");
+			logMessage("Transport overhead: " + String(overhead, 1) + " us per block, "
+				+ String(missed) + " missed blocks");
+
+			expectEquals(missed, 0, "The bridge missed blocks");
+			expect(overhead < overheadBudgetMicros, "The round trip added more than " + String(overheadBudgetMicros) + " us per block");
+		}
+
+		static constexpr int blockSize = 64, numBlocks = 5000;
+		static constexpr double sampleRate = 48000.0;
+
+		// About what a futex wake-up costs when the other side has gone to sleep.
+		static constexpr double overheadBudgetMicros = 20.0;
+	};
+
+	static SandboxRoundTripBenchmark sandboxRoundTripBenchmark;
+
+	//==============================================================================
+	class ProgramChangeBenchmark : public UnitTest
+	{
+	public:
+		ProgramChangeBenchmark() : UnitTest("Program change", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			std::unique_ptr<MicroChromoAudioProcessor> processor;
+			int equal = 0, meantone = 0, fourClones = 0;
+			runOnMessageThread([&]
+			{
+				processor.reset(new MicroChromoAudioProcessor());
+				processor->setAutosaveEnabled(false);
+				processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+				processor->prepareToPlay(sampleRate, blockSize);
+				processor->setProgramCrossfade(10.0f);
+
+				// Equal temperament, quarter-comma meantone, and equal
+				// temperament again over four instances instead of one.
+				static const float meantoneCents[12] = { 0.0f, -24.0f, -7.0f, 10.0f, -14.0f, 3.0f, -21.0f, -3.0f, -27.0f, -10.0f, 7.0f, -17.0f };
+				Array<float> offsets;
+				offsets.insertMultiple(0, 0.0f, 128);
+				processor->setNoteOffsets(offsets);
+				equal = processor->storeProgram("Equal");
+
+				for (int note = 0; note < 128; ++note)
+					offsets.set(note, meantoneCents[note % 12]);
+				processor->setNoteOffsets(offsets);
+				meantone = processor->storeProgram("Meantone");
+
+				for (int note = 0; note < 128; ++note)
+					offsets.set(note, 0.0f);
+				processor->setNoteOffsets(offsets);
+				processor->setNumInstances(4);
+				fourClones = processor->storeProgram("Four Clones");
+				processor->setCurrentProgram(equal);
+			});
+
+			// The host's audio thread keeps rendering throughout.
+			AudioLoop audio(*processor);
+			audio.startThread(9);
+
+			const auto blockMicros = blockSize / sampleRate * 1.0e6;
+			logMessage(String(blockSize) + " samples per block (" + String(blockMicros, 0) + " us)");
+
+			beginTest("Tunings, from the message thread");
+			{
+				const auto switching = switchOnMessageThread(*processor, { equal, meantone }, 200);
+				const auto blocks = summarise(audio.takeBlockMicros());
+
+				logMessage("setCurrentProgram: " + switching.toString());
+				logMessage("Blocks meanwhile: " + blocks.toString());
+
+				expectEquals(processor->getCurrentProgram(), meantone);
+				expect(switching.worstMicros < blockMicros, "A switch took longer than a block");
+				expect(blocks.worstMicros < blockMicros, "A block overran while switching");
+			}
+
+			beginTest("Instance counts, from the message thread");
+			{
+				// These rebuild the graph, with processing suspended meanwhile.
+				const auto switching = switchOnMessageThread(*processor, { fourClones, equal }, 20);
+				const auto blocks = summarise(audio.takeBlockMicros());
+
+				logMessage("setCurrentProgram: " + switching.toString());
+				logMessage("Blocks meanwhile: " + blocks.toString());
+
+				expectEquals(processor->getCurrentProgram(), equal);
+				expect(blocks.worstMicros < blockMicros, "A block overran while the graph was rebuilt");
+			}
+
+			beginTest("Tunings and instance counts, from the audio thread");
+			{
+				// The call only notes the program; the message thread applies it.
+				std::vector<double> appliedMs;
+				const int cycle[] = { meantone, fourClones, equal };
+
+				for (int i = 0; i < 30; ++i)
+				{
+					const auto program = cycle[i % 3];
+					const auto start = Time::getMillisecondCounterHiRes();
+					audio.requestProgram(program);
+
+					while ((audio.isProgramRequested() || processor->isProgramChangePending())
+						&& Time::getMillisecondCounterHiRes() - start < 5000.0)
+						Thread::sleep(1);
+
+					appliedMs.push_back(Time::getMillisecondCounterHiRes() - start);
+					expectEquals(processor->getCurrentProgram(), program);
+				}
+
+				const auto calls = summarise(audio.takeCallMicros());
+				const auto applied = summarise(appliedMs);
+				const auto blocks = summarise(audio.takeBlockMicros());
+
+				logMessage("setCurrentProgram on the audio thread: " + calls.toString());
+				logMessage("Applied after: median " + String(applied.medianMicros, 1) + " ms, worst " + String(applied.worstMicros, 1) + " ms");
+				logMessage("Blocks meanwhile: " + blocks.toString());
+
+				expect(calls.worstMicros < blockMicros * 0.01, "Calling from the audio thread took more than 1% of a block");
+				expect(blocks.worstMicros < blockMicros, "A block overran while switching");
+			}
+
+			audio.stopThread(5000);
+
+			runOnMessageThread([&]
+			{
+				processor->releaseResources();
+				processor = nullptr;
+			});
+		}
+
+	private:
+		Timing switchOnMessageThread(MicroChromoAudioProcessor& processor, std::initializer_list<int> programs, int numSwitches)
+		{
+			std::vector<double> micros;
+			micros.reserve((size_t)numSwitches);
+
+			for (int i = 0; i < numSwitches; ++i)
+			{
+				const auto program = *(programs.begin() + i % (int)programs.size());
+				runOnMessageThread([&]
+				{
+					const auto startTicks = Time::getHighResolutionTicks();
+					processor.setCurrentProgram(program);
+					micros.push_back(microsSince(startTicks));
+				});
+
+				Thread::sleep(5);
+			}
+
+			return summarise(std::move(micros));
+		}
+
+		/** Renders blocks about once a millisecond the way a host does, timing each, until stopped. */
+		class AudioLoop : public Thread
+		{
+		public:
+			AudioLoop(AudioProcessor& p)
+				: Thread("Benchmark Audio"), processor(p),
+				  buffer(jmax(2, p.getTotalNumInputChannels(), p.getTotalNumOutputChannels()), blockSize)
+			{
+				blockMicros.reserve(maxTimings);
+				callMicros.reserve(maxTimings);
+			}
+
+			/** Has the next block call setCurrentProgram() first. */
+			void requestProgram(int index) noexcept { requestedProgram = index; }
+			bool isProgramRequested() const noexcept { return requestedProgram.load() >= 0; }
+
+			/** Returns the timings so far and starts over; with the loop's lock held, so not mid-block. */
+			std::vector<double> takeBlockMicros() { const ScopedLock sl(timingLock); auto taken = blockMicros; blockMicros.clear(); return taken; }
+			std::vector<double> takeCallMicros() { const ScopedLock sl(timingLock); auto taken = callMicros; callMicros.clear(); return taken; }
+
+			void run() override
+			{
+				MidiBuffer midi;
+				for (auto note : { 48, 52, 55, 60, 64 })
+					midi.addEvent(MidiMessage::noteOn(1, note, (uint8)100), 0);
+
+				while (!threadShouldExit())
+				{
+					{
+						const ScopedLock sl(timingLock);
+
+						const auto program = requestedProgram.load();
+						if (program >= 0 && callMicros.size() < maxTimings)
+						{
+							const auto startTicks = Time::getHighResolutionTicks();
+							processor.setCurrentProgram(program);
+							callMicros.push_back(microsSince(startTicks));
+							requestedProgram = -1;
+						}
+
+						// As the plugin wrappers do: a suspended processor is not called.
+						const auto startTicks = Time::getHighResolutionTicks();
+						{
+							const ScopedLock callbackLock(processor.getCallbackLock());
+							if (processor.isSuspended())
+								buffer.clear();
+							else
+								processor.processBlock(buffer, midi);
+						}
+
+						if (blockMicros.size() < maxTimings)
+							blockMicros.push_back(microsSince(startTicks));
+					}
+
+					midi.clear();
+					wait(1);
+				}
+			}
+
+		private:
+			static constexpr size_t maxTimings = 100000;
+
+			AudioProcessor& processor;
+			AudioBuffer<float> buffer;
+			std::atomic<int> requestedProgram{ -1 };
+			std::vector<double> blockMicros, callMicros;
+			CriticalSection timingLock;
+		};
+
+		static constexpr int blockSize = 256;
+		static constexpr double sampleRate = 48000.0;
+	};
+
+	static ProgramChangeBenchmark programChangeBenchmark;
+
+	//==============================================================================
+	class LookaheadSchedulingBenchmark : public UnitTest
+	{
+	public:
+		LookaheadSchedulingBenchmark() : UnitTest("Lookahead scheduling", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			for (auto mode : { MidiRouter::OutputMode::clones, MidiRouter::OutputMode::mpe })
+			{
+				const auto name = String(mode == MidiRouter::OutputMode::mpe ? "MPE" : "Clones");
+				beginTest(name + ", " + String(notesPerBlock) + " note-ons and note-offs per block");
+
+				const auto direct = run(mode, 0);
+				const auto ahead = run(mode, lookaheadSamples);
+				const auto blockMicros = blockSize / sampleRate * 1.0e6;
+
+				logMessage("Without lookahead: " + direct.toString());
+				logMessage("With " + String(lookaheadSamples) + " samples of lookahead: " + ahead.toString());
+
+				expect(ahead.worstMicros < blockMicros * budgetShare, "Scheduling a block took more than "
+					+ String(budgetShare * 100.0) + "% of the block");
+			}
+		}
+
+	private:
+		Timing run(MidiRouter::OutputMode mode, int lookahead)
+		{
+			const auto numInstances = mode == MidiRouter::OutputMode::mpe ? 1 : maxInstances;
+
+			MidiEventPool pool;
+			MidiRouter router(pool);
+			router.setOutputMode(mode);
+			router.setMpeZone(true, 15, 48);
+			router.setLookahead(lookahead);
+			pool.prepare(numInstances, blockSize);
+			router.prepare(numInstances, sampleRate, blockSize);
+
+			// Every note gets its own offset, so every one needs a voice re-bent for it.
+			Array<float> offsets;
+			for (int note = 0; note < 128; ++note)
+				offsets.add((float)((note * 37) % 100) - 50.0f);
+			router.setNoteOffsets(offsets);
+
+			// Each block ends the notes the block before started and starts as
+			// many new ones, spread over the block, with a controller between.
+			constexpr int numPatterns = 4;
+			std::vector<MidiBuffer> input((size_t)numPatterns);
+			for (int b = 0; b < numPatterns; ++b)
+			{
+				const auto firstOn = 36 + b * notesPerBlock;
+				const auto firstOff = 36 + ((b + numPatterns - 1) % numPatterns) * notesPerBlock;
+
+				for (int i = 0; i < notesPerBlock; ++i)
+				{
+					const auto position = i * blockSize / notesPerBlock;
+					input[(size_t)b].addEvent(MidiMessage::noteOff(1, firstOff + i), position);
+					input[(size_t)b].addEvent(MidiMessage::noteOn(1, firstOn + i, (uint8)(60 + i)), position);
+					input[(size_t)b].addEvent(MidiMessage::controllerEvent(1, 74, i * 4), position);
+				}
+			}
+
+			auto scheduleBlock = [&, block = 0]() mutable
+			{
+				router.process(input[(size_t)block], blockSize);
+				block = (block + 1) % numPatterns;
+			};
+
+			for (int i = 0; i < 1000; ++i)
+				scheduleBlock();
+
+			const auto timing = measure(numBlocks, scheduleBlock);
+			expectEquals(pool.getNumDroppedEvents(), 0, "The pool dropped events");
+			return timing;
+		}
+
+		static constexpr int maxInstances = 16, notesPerBlock = 16, blockSize = 64, numBlocks = 20000;
+		static constexpr int lookaheadSamples = 480;
+		static constexpr double sampleRate = 48000.0;
+
+		// The worst block, not the typical one, is what decides a dropout.
+		static constexpr double budgetShare = 0.25;
+	};
+
+	static LookaheadSchedulingBenchmark lookaheadSchedulingBenchmark;
+
+	//==============================================================================
+	class LoadSheddingBenchmark : public UnitTest
+	{
+	public:
+		LoadSheddingBenchmark() : UnitTest("Load shedding", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			beginTest("Stealing down to a voice limit");
+			runSteals();
+
+			beginTest("Overruns with and without shedding, " + String(numInstances) + " instances, "
+				+ String(blockSize) + " samples per block");
+			runOverload();
+		}
+
+	private:
+		/** Times the block in which the router releases all notes over a new voice limit. */
+		void runSteals()
+		{
+			MidiEventPool pool;
+			MidiRouter router(pool);
+			pool.prepare(numInstances, blockSize);
+			router.prepare(numInstances, sampleRate, blockSize);
+
+			// Filled a quarter at a time, so no block holds more events than the pool.
+			constexpr int numNotes = 512, voiceLimit = 64;
+			std::vector<MidiBuffer> noteOns(4), noteOffs(4);
+			for (int i = 0; i < numNotes; ++i)
+			{
+				const auto channel = 1 + i % 16, note = 24 + i / 16;
+				noteOns[(size_t)(i % 4)].addEvent(MidiMessage::noteOn(channel, note, (uint8)(1 + (i * 53) % 127)), i % blockSize);
+				noteOffs[(size_t)(i % 4)].addEvent(MidiMessage::noteOff(channel, note), i % blockSize);
+			}
+
+			const MidiBuffer none;
+			std::vector<double> micros;
+			micros.reserve(numRounds);
+
+			for (int round = 0; round < numRounds; ++round)
+			{
+				router.setVoiceLimit(0);
+				for (auto& block : noteOns)
+					router.process(block, blockSize);
+
+				router.setVoiceLimit(voiceLimit);
+				const auto startTicks = Time::getHighResolutionTicks();
+				router.process(none, blockSize);
+				micros.push_back(microsSince(startTicks));
+
+				expectEquals(router.getNumSoundingNotes(), voiceLimit);
+
+				router.setVoiceLimit(0);
+				for (auto& block : noteOffs)
+					router.process(block, blockSize);
+			}
+
+			const auto timing = summarise(micros);
+			const auto blockMicros = blockSize / sampleRate * 1.0e6;
+
+			logMessage("Releasing " + String(numNotes - voiceLimit) + " of " + String(numNotes) + " notes: " + timing.toString());
+			expectEquals(pool.getNumDroppedEvents(), 0, "The pool dropped note-offs");
+			expect(timing.worstMicros < blockMicros * 0.25, "Stealing took more than a quarter of the block");
+		}
+
+		/** Raises the number of held notes until blocks overrun without shedding, then renders the same with it. */
+		void runOverload()
+		{
+			for (int heldNotes = 256; heldNotes <= maxHeldNotes; heldNotes *= 2)
+			{
+				const auto without = render(heldNotes, false);
+				if (without < numBlocks / 100)
+				{
+					logMessage(String(heldNotes) + " notes: " + String(without) + " overruns without shedding, too few to compare");
+					continue;
+				}
+
+				const auto with = render(heldNotes, true);
+				logMessage(String(heldNotes) + " notes: " + String(without) + " overruns without shedding, "
+					+ String(with) + " with it, out of " + String(numBlocks) + " blocks");
+
+				// The governor needs a few blocks per level to react, so some remain.
+				expect(with * 4 < without, "Shedding did not prevent most of the overruns");
+				return;
+			}
+
+			logMessage("No overruns up to " + String(maxHeldNotes) + " notes on this machine; nothing to compare");
+		}
+
+		/** Returns the number of blocks that took longer than their duration. */
+		int render(int heldNotes, bool shedLoad)
+		{
+			std::unique_ptr<MicroChromoAudioProcessor> processor;
+			runOnMessageThread([&]
+			{
+				processor.reset(new MicroChromoAudioProcessor());
+				processor->setAutosaveEnabled(false);
+				processor->setNumInstances(numInstances);
+				processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+				processor->prepareToPlay(sampleRate, blockSize);
+				processor->setLoadSheddingEnabled(shedLoad);
+			});
+
+			AudioBuffer<float> buffer(jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()), blockSize);
+			MidiBuffer midi;
+			const auto blockMicros = blockSize / sampleRate * 1.0e6;
+			int numOverruns = 0;
+
+			// Every block starts eight notes and ends the eight started heldNotes
+			// notes before, over all 16 channels, so heldNotes keep sounding.
+			constexpr int notesPerBlock = 8, numKeys = 16 * 84;
+			for (int block = 0; block < numBlocks; ++block)
+			{
+				midi.clear();
+				for (int i = 0; i < notesPerBlock; ++i)
+				{
+					const auto on = (block * notesPerBlock + i) % numKeys;
+					const auto off = (block * notesPerBlock + i + numKeys - heldNotes % numKeys) % numKeys;
+					midi.addEvent(MidiMessage::noteOff(1 + off % 16, 24 + off / 16), i);
+					midi.addEvent(MidiMessage::noteOn(1 + on % 16, 24 + on / 16, (uint8)(1 + (on * 53) % 127)), i);
+				}
+
+				const auto startTicks = Time::getHighResolutionTicks();
+				processor->processBlock(buffer, midi);
+				if (microsSince(startTicks) >= blockMicros)
+					++numOverruns;
+			}
+
+			runOnMessageThread([&]
+			{
+				processor->releaseResources();
+				processor = nullptr;
+			});
+
+			return numOverruns;
+		}
+
+		static constexpr int numInstances = 16, blockSize = 32, numBlocks = 3000, numRounds = 200;
+		static constexpr int maxHeldNotes = 1024;
+		static constexpr double sampleRate = 48000.0;
+	};
+
+	static LoadSheddingBenchmark loadSheddingBenchmark;
+
+	//==============================================================================
+	class AdaptiveTuningBenchmark : public UnitTest
+	{
+	public:
+		AdaptiveTuningBenchmark() : UnitTest("Adaptive tuning", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			// Every key from C2 up, once in order and once shuffled, so the root keeps moving.
+			Array<int> ascending, shuffled;
+			for (int i = 0; i < clusterSize; ++i)
+				ascending.add(36 + i);
+
+			shuffled = ascending;
+			Random random(42);
+			for (int i = clusterSize - 1; i > 0; --i)
+				shuffled.swap(i, random.nextInt(i + 1));
+
+			beginTest("The engine, 64-note clusters");
+			runEngine("In order", ascending);
+			runEngine("Shuffled", shuffled);
+
+			beginTest("The router, a 64-note cluster in one block");
+			runRouter(shuffled);
+		}
+
+	private:
+		void runEngine(const String& name, const Array<int>& notes)
+		{
+			AdaptiveTuning tuning;
+			int numChanges = 0;
+
+			// Each round presses the cluster and releases it in reverse, as if lifting fingers.
+			std::vector<double> perEvent;
+			perEvent.reserve(numRounds);
+			for (int round = 0; round < numRounds; ++round)
+			{
+				const auto startTicks = Time::getHighResolutionTicks();
+				for (auto note : notes)
+					numChanges += tuning.noteOn(note) ? 1 : 0;
+				for (int i = notes.size(); --i >= 0;)
+					numChanges += tuning.noteOff(notes.getUnchecked(i)) ? 1 : 0;
+				perEvent.push_back(microsSince(startTicks) / (2 * notes.size()));
+			}
+
+			const auto timing = summarise(perEvent);
+
+			logMessage(name + ": median " + String(timing.medianMicros * 1000.0, 1) + " ns per event, worst round "
+				+ String(timing.worstMicros * 1000.0, 1) + " ns per event, " + String(numChanges) + " retunes");
+			expect(timing.medianMicros * 1000.0 < eventBudgetNs, name + ": events took more than " + String(eventBudgetNs) + " ns on average");
+		}
+
+		void runRouter(const Array<int>& notes)
+		{
+			MidiEventPool pool;
+			MidiRouter router(pool);
+			router.setAdaptiveTuning(true, 20.0f);
+			router.setGlide(5.0f, 0.0f, GlideEngine::Shape::linear);
+			pool.prepare(numInstances, blockSize);
+			router.prepare(numInstances, sampleRate, blockSize);
+
+			MidiBuffer noteOns, noteOffs;
+			for (int i = 0; i < notes.size(); ++i)
+			{
+				noteOns.addEvent(MidiMessage::noteOn(1, notes.getUnchecked(i), (uint8)100), i);
+				noteOffs.addEvent(MidiMessage::noteOff(1, notes.getUnchecked(i)), i);
+			}
+
+			const MidiBuffer none;
+			std::vector<double> micros;
+			micros.reserve(numRounds);
+
+			for (int round = 0; round < numRounds; ++round)
+			{
+				const auto startTicks = Time::getHighResolutionTicks();
+				router.process(noteOns, blockSize);
+				micros.push_back(microsSince(startTicks));
+
+				// Let the glides finish before the cluster is released.
+				for (int i = 0; i < 8; ++i)
+					router.process(none, blockSize);
+				router.process(noteOffs, blockSize);
+			}
+
+			const auto timing = summarise(micros);
+			const auto blockMicros = blockSize / sampleRate * 1.0e6;
+
+			logMessage(String(numInstances) + " instances, " + String(blockSize) + " samples per block: " + timing.toString());
+			expectEquals(pool.getNumDroppedEvents(), 0, "The pool dropped events");
+			expect(timing.worstMicros < blockMicros * 0.25, "The cluster took more than a quarter of the block");
+		}
+
+		static constexpr int clusterSize = 64, numRounds = 10000, numInstances = 16, blockSize = 64;
+		static constexpr double sampleRate = 48000.0;
+
+		// A table lookup and at most twelve offsets.
+		static constexpr double eventBudgetNs = 200.0;
+	};
+
+	static AdaptiveTuningBenchmark adaptiveTuningBenchmark;
+
+	//==============================================================================
+	class RenderDispatchBenchmark : public UnitTest
+	{
+	public:
+		RenderDispatchBenchmark() : UnitTest("Render dispatch", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			// The unrolled counts, and two that take the loop.
+			for (auto numInstances : { 1, 2, 4, 8, 12, 16, 32 })
+			{
+				beginTest(String(numInstances) + " instances");
+
+				const auto graph = render(numInstances, false);
+				const auto frozen = render(numInstances, true);
+				const auto perNode = (graph.medianMicros - frozen.medianMicros) / numInstances;
+
+				logMessage("Graph: " + graph.toString());
+				logMessage("Schedule: " + frozen.toString());
+				logMessage("Saved per instance: " + String(perNode * 1000.0, 0) + " ns");
+
+				expect(frozen.medianMicros <= graph.medianMicros, "The schedule was slower than the graph");
+			}
+		}
+
+	private:
+		Timing render(int numInstances, bool frozen)
+		{
+			std::unique_ptr<MicroChromoAudioProcessor> processor;
+			runOnMessageThread([&]
+			{
+				processor.reset(new MicroChromoAudioProcessor());
+				processor->setAutosaveEnabled(false);
+				processor->setNumInstances(numInstances);
+				processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+				processor->prepareToPlay(sampleRate, blockSize);
+				processor->setTopologyFrozen(frozen);
+				processor->setLoadSheddingEnabled(false);
+			});
+
+			AudioBuffer<float> buffer(jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()), blockSize);
+			MidiBuffer midi;
+
+			// A controller in every block keeps the processor from skipping
+			// the instances as idle, while the instances themselves have
+			// nothing to play; what is left is the cost of getting to them.
+			auto renderBlock = [&, value = 0]() mutable
+			{
+				midi.clear();
+				midi.addEvent(MidiMessage::controllerEvent(1, 1, value), 0);
+				value = (value + 1) % 128;
+				processor->processBlock(buffer, midi);
+			};
+
+			// The graph prepares new instances asynchronously; until it has,
+			// the schedule hands over to it.
+			for (int i = 0; i < 1000; ++i)
+				renderBlock();
+
+			const auto timing = measure(numBlocks, renderBlock);
+
+			runOnMessageThread([&]
+			{
+				processor->releaseResources();
+				processor = nullptr;
+			});
+
+			return timing;
+		}
+
+		static constexpr int blockSize = 64, numBlocks = 20000;
+		static constexpr double sampleRate = 48000.0;
+	};
+
+	static RenderDispatchBenchmark renderDispatchBenchmark;
+
+	//==============================================================================
+	class ReprepareBenchmark : public UnitTest
+	{
+	public:
+		ReprepareBenchmark() : UnitTest("Re-prepare", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			// The reference synth prepares in no time, so these mostly time
+			// the graph and the handing out of the instances.
+			for (auto numInstances : { 1, 2, 4, 8, 16, 32 })
+			{
+				beginTest("Reference synth, " + String(numInstances) + " instances");
+				run(numInstances, nullptr, 10);
+			}
+
+			// Sandboxed instances prepare in their bridges, side by side.
+			SharedResourcePointer<PluginDatabase> database;
+			PluginDescription description;
+			if (!findFirstInstrument(*database, description))
+			{
+				logMessage("Skipped the sandboxed runs: there is no instrument in the plugin list");
+				return;
+			}
+
+			for (auto numInstances : { 1, 4, 16 })
+			{
+				beginTest(description.name + " sandboxed, " + String(numInstances) + " instances");
+				run(numInstances, &description, 3);
+			}
+		}
+
+	private:
+		void run(int numInstances, const PluginDescription* sandboxedBackend, int numRounds)
+		{
+			Timing reprepare, rebuild;
+			runOnMessageThread([&]
+			{
+				MicroChromoAudioProcessor processor;
+				processor.setAutosaveEnabled(false);
+				processor.setNumInstances(numInstances);
+
+				if (sandboxedBackend != nullptr)
+				{
+					processor.setSandboxEnabled(true);
+					processor.setBackend(*sandboxedBackend);
+				}
+
+				prepare(processor, 0);
+
+				// Each call switches rate and block size, as a host does
+				// when its settings change.
+				reprepare = measure(numRounds, [&, round = 0]() mutable { prepare(processor, ++round); });
+
+				// What every prepare used to cost: a new graph with new instances.
+				rebuild = measure(numRounds, [&] { processor.initializeGraph(); });
+
+				processor.releaseResources();
+			});
+
+			logMessage("Re-prepare: " + reprepare.toString());
+			logMessage("Rebuild: " + rebuild.toString() + " ("
+				+ String(rebuild.medianMicros / jmax(1.0, reprepare.medianMicros), 1) + " times as long)");
+
+			expect(reprepare.medianMicros < rebuild.medianMicros, "Re-preparing took as long as rebuilding the graph");
+		}
+
+		static void prepare(MicroChromoAudioProcessor& processor, int round)
+		{
+			const auto sampleRate = round % 2 == 0 ? 48000.0 : 44100.0;
+			const auto blockSize = round % 2 == 0 ? 256 : 512;
+
+			processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+			processor.prepareToPlay(sampleRate, blockSize);
+		}
+	};
+
+	static ReprepareBenchmark reprepareBenchmark;
+
+	//==============================================================================
+	class UndoHistoryBenchmark : public UnitTest
+	{
+	public:
+		UndoHistoryBenchmark() : UnitTest("Undo history", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			beginTest(String(numEdits) + " rebuilding edits, " + String(numInstances) + " instances with "
+				+ String(stateBytes / 1024) + "KB of state each");
+
+			// Stands in for the processor: every restore rebuilds, and the
+			// instances hand their states to the history first.
+			Array<MemoryBlock> live;
+			GraphHistory* historyPtr = nullptr;
+			GraphHistory history([&](const GraphHistory::Snapshot& snapshot)
+			{
+				historyPtr->refreshNodeStates(live);
+				live = makeDefaultStates();
+
+				if (snapshot.nodeStates != nullptr)
+					for (int i = 0; i < jmin(live.size(), snapshot.nodeStates->size()); ++i)
+						if (auto blob = (*snapshot.nodeStates)[i])
+							live.set(i, *blob);
+			});
+			historyPtr = &history;
+
+			Random random(42);
+			live = makeDefaultStates();
+
+			std::vector<double> micros;
+			size_t peakBytes = 0;
+			int peakBlobs = 0;
+			Array<MemoryBlock> beforeLastEdit;
+
+			for (int edit = 0; edit < numEdits; ++edit)
+			{
+				// The user changes every instance, then changes the topology.
+				for (auto& state : live)
+					random.fillBitsRandomly(state.getData(), state.getSize());
+
+				beforeLastEdit = live;
+
+				const auto startTicks = Time::getHighResolutionTicks();
+				history.refreshNodeStates(live);
+
+				GraphHistory::Topology topology;
+				topology.numInstances = numInstances;
+				topology.lookaheadSamples = edit + 1;
+				history.commit("Edit", std::move(topology), {}, {});
+				live = makeDefaultStates();
+				micros.push_back(microsSince(startTicks));
+
+				peakBytes = jmax(peakBytes, history.getNumBlobBytes());
+				peakBlobs = jmax(peakBlobs, history.getNumBlobs());
+			}
+
+			const auto bytesPerEdit = (size_t)(numInstances * stateBytes);
+			logMessage("Commit: " + summarise(std::move(micros)).toString());
+			logMessage("Peak: " + String(peakBlobs) + " blobs, " + String((int64)(peakBytes / (1024 * 1024))) + "MB");
+
+			// The bound may be overshot by the step that pushed it over.
+			const auto maxBytes = (size_t)GraphHistory::maxHistoryBytes + bytesPerEdit;
+			expect(peakBytes <= maxBytes, "The history kept more state than its limit: " + String((int64)peakBytes));
+			expect(peakBlobs <= (int)(maxBytes / (size_t)stateBytes), "The history kept too many blobs: " + String(peakBlobs));
+
+			beginTest("Undo and redo bring the states back");
+
+			expect(history.undo());
+			expect(live == beforeLastEdit, "Undoing did not restore the instance states");
+
+			// The states left by the undo come back with the redo, and the
+			// ones the redo leaves come back with the next undo.
+			for (auto& state : live)
+				random.fillBitsRandomly(state.getData(), state.getSize());
+			const auto beforeRedo = live;
+
+			expect(history.redo());
+			expect(history.undo());
+			expect(live == beforeRedo, "Undoing after a redo did not restore the instance states");
+
+			const auto bytesAfterUndo = history.getNumBlobBytes();
+			expect(bytesAfterUndo <= maxBytes + bytesPerEdit, "Undo and redo grew the history past its limit");
+
+			history.reset({}, {}, {});
+			expect(history.getNumBlobs() == 0, "Resetting kept " + String(history.getNumBlobs()) + " blobs");
+		}
+
+	private:
+		static Array<MemoryBlock> makeDefaultStates()
+		{
+			Array<MemoryBlock> states;
+			for (int i = 0; i < numInstances; ++i)
+				states.add(MemoryBlock((size_t)stateBytes, true));
+			return states;
+		}
+
+		static constexpr int numEdits = 300, numInstances = 4, stateBytes = 256 * 1024;
+	};
+
+	static UndoHistoryBenchmark undoHistoryBenchmark;
+
+	//==============================================================================
+	class ReferenceSynthBenchmark : public UnitTest
+	{
+	public:
+		ReferenceSynthBenchmark() : UnitTest("Reference synth", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			beginTest(String(ReferenceSynth::maxVoices) + " voices, " + String(blockSize) + "-sample blocks");
+
+			ReferenceSynth synth;
+			synth.setPlayConfigDetails(0, 2, sampleRate, blockSize);
+			synth.prepareToPlay(sampleRate, blockSize);
+
+			// 16 notes on each of the 16 channels fill every voice without stealing.
+			MidiBuffer notes;
+			for (int i = 0; i < ReferenceSynth::maxVoices; ++i)
+				notes.addEvent(MidiMessage::noteOn(i % 16 + 1, 36 + i / 16, (uint8)100), 0);
+
+			AudioBuffer<float> buffer(2, blockSize);
+			synth.processBlock(buffer, notes);
+			expectEquals(synth.getNumActiveVoices(), ReferenceSynth::maxVoices);
+
+			MidiBuffer none;
+			const auto timing = measure(numBlocks, [&] { synth.processBlock(buffer, none); });
+			const auto blockMicros = blockSize / sampleRate * 1.0e6;
+
+			logMessage("Block: " + timing.toString() + " of " + String(blockMicros, 1) + " us ("
+				+ String(100.0 * timing.medianMicros / blockMicros, 1) + "% median)");
+
+			expectEquals(synth.getNumActiveVoices(), ReferenceSynth::maxVoices);
+			expect(timing.medianMicros < 0.25 * blockMicros, "Rendering took more than a quarter of the block");
+		}
+
+	private:
+		static constexpr double sampleRate = 48000.0;
+		static constexpr int blockSize = 64, numBlocks = 5000;
+	};
+
+	static ReferenceSynthBenchmark referenceSynthBenchmark;
+
+	//==============================================================================
+	class PluginIndexBenchmark : public UnitTest
+	{
+	public:
+		PluginIndexBenchmark() : UnitTest("Plugin index", Benchmarks::category) {}
+
+		void runTest() override
+		{
+			beginTest(String(numPlugins) + " plugins");
+
+			KnownPluginList list;
+			Random random(42);
+			for (int i = 0; i < numPlugins; ++i)
+				list.addType(makeDescription(i, random));
+
+			PluginIndex index;
+			const auto rebuild = measure(1, [&] { index.rebuild(list); });
+			logMessage("Rebuild: " + rebuild.toString());
+			expectEquals(index.getNumPlugins(), numPlugins);
+
+			// Switching the sort method lists every plugin in the new order.
+			std::vector<int> results;
+			const auto sortSwitch = measure(numRounds, [&, round = 0]() mutable
+			{
+				index.search({}, (PluginIndex::SortMethod)(++round % PluginIndex::numSortMethods), true, results);
+			});
+
+			logMessage("Sort switch: " + sortSwitch.toString());
+			expectEquals((int)results.size(), numPlugins);
+			expect(sortSwitch.medianMicros < 1000.0, "Switching the sort method took more than 1 ms");
+
+			// Every round sorts by the next method, so the first search by each
+			// one after the rebuild also works out its ranks.
+			for (auto query : { "syn", "maker 12", "chorus pad" })
+			{
+				const auto search = measure(numRounds, [&, round = 0]() mutable
+				{
+					index.search(query, (PluginIndex::SortMethod)(++round % PluginIndex::numSortMethods), true, results);
+				});
+
+				logMessage("Search \"" + String(query) + "\": " + search.toString() + ", " + String((int)results.size()) + " results");
+				expect(search.medianMicros < 1000.0, "Searching for \"" + String(query) + "\" took more than 1 ms");
+			}
+
+			beginTest("Updating after a scan finds one more");
+
+			const auto update = measure(numRounds, [&, round = 0]() mutable
+			{
+				list.addType(makeDescription(numPlugins + round++, random));
+				index.update(list);
+			});
+
+			logMessage("Update: " + update.toString() + " (rebuild " + rebuild.toString() + ")");
+			expectEquals(index.getNumPlugins(), numPlugins + numRounds);
+			expect(update.medianMicros < rebuild.medianMicros, "Updating took as long as rebuilding the index");
+		}
+
+	private:
+		static PluginDescription makeDescription(int i, Random& random)
+		{
+			static const char* const kinds[] = { "Synth", "Verb", "Delay", "Comp", "Chorus", "Phaser", "Pad", "Bass",
+				"Lead", "Drum", "Keys", "Strings", "Organ", "Limiter", "Gate", "Flanger" };
+			static const char* const categories[] = { "Synth", "Instrument", "Fx", "Reverb", "Dynamics", "Modulation" };
+			const auto numKinds = (int)(sizeof(kinds) / sizeof(kinds[0]));
+			const auto numCategories = (int)(sizeof(categories) / sizeof(categories[0]));
+
+			PluginDescription description;
+			description.name = String(kinds[random.nextInt(numKinds)]) + " " + kinds[random.nextInt(numKinds)] + " " + String(i);
+			description.manufacturerName = "Maker " + String(i % 300);
+			description.category = categories[random.nextInt(numCategories)];
+			description.pluginFormatName = i % 2 == 0 ? "VST3" : "AudioUnit";
+			description.fileOrIdentifier = "/Plugins/" + description.manufacturerName + "/" + String(i) + ".vst3";
+			description.uid = i;
+			description.isInstrument = description.category == "Synth" || description.category == "Instrument";
+			description.lastInfoUpdateTime = Time(2026, 0, 1 + i % 28, 0, 0) + RelativeTime::milliseconds(i);
+			return description;
+		}
+
+		static constexpr int numPlugins = 10000, numRounds = 50;
+	};
+
+	static PluginIndexBenchmark pluginIndexBenchmark;
+}
+
+//==============================================================================
+int Benchmarks::runFromCommandLine(const String& commandLine)
+{
+	auto args = StringArray::fromTokens(commandLine, true);
+	for (auto& arg : args)
+		arg = arg.unquoted();
+
+	const auto flagIndex = args.indexOf(commandLineFlag);
+	const auto filter = args[flagIndex + 1].startsWith("-") ? String() : args[flagIndex + 1];
+
+	Array<UnitTest*> tests;
+	for (auto* test : UnitTest::getTestsInCategory(category))
+		if (filter.isEmpty() || test->getName().containsIgnoreCase(filter))
+			tests.add(test);
+
+	BenchmarkRunner runner;
+	runner.runTests(tests);
+
+	int numFailures = 0;
+	for (int i = 0; i < runner.getNumResults(); ++i)
+		numFailures += runner.getResult(i)->failures;
+
+	return numFailures > 0 ? 1 : 0;
+}
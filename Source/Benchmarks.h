@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    Benchmarks.h
+    Created: 20 Oct 2026 2:31:09am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Timed checks of the real-time and startup paths, run from the standalone
+    application with --benchmark instead of opening a window.
+
+    Every benchmark is a UnitTest in the "Benchmarks" category. It logs the
+    median and worst time of each case and fails when a case misses its
+    budget, so the exit code tells whether a build still meets them. Setup
+    that plugins expect on the message thread is run there, while the
+    benchmark waits on its own thread, as the batch renderer does.
+*/
+class Benchmarks
+{
+public:
+	/** Handles "--benchmark [name]": runs every benchmark, or those whose name contains name; returns the exit code. */
+	static int runFromCommandLine(const String& commandLine);
+
+	static const char* const commandLineFlag;
+	static const char* const category;
+};
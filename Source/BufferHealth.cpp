@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    BufferHealth.cpp
+    Created: 19 Oct 2026 8:31:26pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "BufferHealth.h"
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr uint32 absMask = 0x7fffffffu;
+	constexpr uint32 infinityBits = 0x7f800000u;
+	constexpr uint32 smallestNormalBits = 0x00800000u;
+
+	inline uint32 toBits(float value) noexcept
+	{
+		uint32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	inline float fromBits(uint32 bits) noexcept
+	{
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+//==============================================================================
+void BufferHealth::merge(const BufferHealth& other) noexcept
+{
+	hasNonFinite = hasNonFinite || other.hasNonFinite;
+	hasDenormals = hasDenormals || other.hasDenormals;
+	peak = jmax(peak, other.peak);
+}
+
+BufferHealth BufferHealth::scan(const float* samples, int numSamples) noexcept
+{
+	BufferHealth result;
+	uint32 nonFinite = 0, denormal = 0, peakBits = 0;
+	int i = 0;
+
+   #if JUCE_USE_SSE_INTRINSICS
+	// On the absolute bit pattern, which compares like an unsigned integer,
+	// anything at or above the infinity pattern is NaN or infinite, and
+	// anything between zero and the smallest normal is a denormal. The
+	// patterns stay below 2^31, so the signed compares are safe.
+	const auto mask = _mm_set1_epi32((int)absMask);
+	const auto maxFinite = _mm_set1_epi32((int)(infinityBits - 1));
+	const auto minNormal = _mm_set1_epi32((int)smallestNormalBits);
+	const auto zero = _mm_setzero_si128();
+
+	auto nonFiniteV = _mm_setzero_si128();
+	auto denormalV = _mm_setzero_si128();
+	auto peakV = _mm_setzero_si128();
+
+	for (; i + 4 <= numSamples; i += 4)
+	{
+		const auto bits = _mm_and_si128(_mm_castps_si128(_mm_loadu_ps(samples + i)), mask);
+
+		nonFiniteV = _mm_or_si128(nonFiniteV, _mm_cmpgt_epi32(bits, maxFinite));
+		denormalV = _mm_or_si128(denormalV, _mm_and_si128(_mm_cmpgt_epi32(bits, zero), _mm_cmplt_epi32(bits, minNormal)));
+
+		// Positive floats order like their bit patterns; NaNs are caught above.
+		const auto greater = _mm_cmpgt_epi32(bits, peakV);
+		peakV = _mm_or_si128(_mm_and_si128(greater, bits), _mm_andnot_si128(greater, peakV));
+	}
+
+	alignas(16) uint32 lanes[4];
+	_mm_store_si128((__m128i*)lanes, nonFiniteV);
+	nonFinite = lanes[0] | lanes[1] | lanes[2] | lanes[3];
+	_mm_store_si128((__m128i*)lanes, denormalV);
+	denormal = lanes[0] | lanes[1] | lanes[2] | lanes[3];
+	_mm_store_si128((__m128i*)lanes, peakV);
+	peakBits = jmax(jmax(lanes[0], lanes[1]), jmax(lanes[2], lanes[3]));
+   #endif
+
+	for (; i < numSamples; ++i)
+	{
+		const auto bits = toBits(samples[i]) & absMask;
+		nonFinite |= bits >= infinityBits ? 1u : 0u;
+		denormal |= (bits != 0 && bits < smallestNormalBits) ? 1u : 0u;
+		peakBits = jmax(peakBits, bits);
+	}
+
+	result.hasNonFinite = nonFinite != 0;
+	result.hasDenormals = denormal != 0;
+	result.peak = result.hasNonFinite ? 0.0f : fromBits(peakBits);
+	return result;
+}
+
+BufferHealth BufferHealth::scan(const AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+	BufferHealth result;
+	for (int ch = 0; ch < jmin(numChannels, buffer.getNumChannels()); ++ch)
+		result.merge(scan(buffer.getReadPointer(ch), numSamples));
+	return result;
+}
+
+void BufferHealth::flushDenormals(float* samples, int numSamples) noexcept
+{
+	for (int i = 0; i < numSamples; ++i)
+		if ((toBits(samples[i]) & absMask) < smallestNormalBits)
+			samples[i] = 0.0f;
+}
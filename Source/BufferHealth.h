@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    BufferHealth.h
+    Created: 19 Oct 2026 8:31:26pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    What a single pass over a block of samples found: NaNs or infinities,
+    denormals, and the peak level for silence detection.
+
+    The scan works on the bit patterns, four samples at a time where SSE2 is
+    available, so it neither depends on nor changes the FPU flags.
+*/
+struct BufferHealth
+{
+	bool hasNonFinite = false;
+	bool hasDenormals = false;
+	float peak = 0.0f;
+
+	bool isSilent(float threshold) const noexcept { return !hasNonFinite && peak <= threshold; }
+	void merge(const BufferHealth& other) noexcept;
+
+	static BufferHealth scan(const float* samples, int numSamples) noexcept;
+	static BufferHealth scan(const AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+	/** Replaces denormals with zero, for the rare block where scan() found some. */
+	static void flushDenormals(float* samples, int numSamples) noexcept;
+};
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    DiskRecorder.cpp
+    Created: 19 Oct 2026 9:52:37pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "DiskRecorder.h"
+
+namespace
+{
+	// Seconds of audio each FIFO holds before blocks are dropped; the mix
+	// gets more, as losing it is what matters most.
+	constexpr double mixFifoSeconds = 4.0;
+	constexpr double instanceFifoSeconds = 1.0;
+
+	// The writer thread waits for at least this much before writing, so the
+	// file sees long sequential writes rather than one per block.
+	constexpr int minWriteSamples = 16384;
+	constexpr size_t fileBufferBytes = 1 << 20;
+
+	std::unique_ptr<AudioFormatWriter> createWriter(const File& file, double sampleRate, int numChannels)
+	{
+		file.deleteFile();
+
+		std::unique_ptr<FileOutputStream> out(file.createOutputStream(fileBufferBytes));
+		if (out == nullptr || !out->openedOk())
+			return nullptr;
+
+		WavAudioFormat wav;
+		std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(out.get(), sampleRate, (unsigned int)numChannels, 24, {}, 0));
+		if (writer != nullptr)
+			out.release();
+
+		return writer;
+	}
+}
+
+//==============================================================================
+DiskRecorder::DiskRecorder()
+{
+}
+
+DiskRecorder::~DiskRecorder()
+{
+	stop();
+	writerThread.stopThread(2000);
+}
+
+bool DiskRecorder::start(const File& mixFile, double sampleRate, int numChannels, int numInstances)
+{
+	stop();
+
+	OwnedArray<Stream> newStreams;
+	const auto instanceChannels = 2;
+
+	for (int i = 0; i <= numInstances; ++i)
+	{
+		const auto isMix = i == 0;
+		const auto channels = isMix ? numChannels : instanceChannels;
+		const auto capacity = roundToInt(sampleRate * (isMix ? mixFifoSeconds : instanceFifoSeconds));
+
+		const auto file = isMix ? mixFile
+			: mixFile.getSiblingFile(mixFile.getFileNameWithoutExtension() + " - Instance " + String(i) + mixFile.getFileExtension());
+
+		auto* stream = newStreams.add(new Stream(capacity, channels));
+		stream->writer = createWriter(file, sampleRate, channels);
+
+		if (stream->writer == nullptr)
+			return false;
+	}
+
+	{
+		const SpinLock::ScopedLockType sl(streamLock);
+		streams.swapWith(newStreams);
+		numOverruns = 0;
+		recording = true;
+	}
+
+	writerThread.addTimeSliceClient(this);
+	if (!writerThread.isThreadRunning())
+		writerThread.startThread(3);
+
+	return true;
+}
+
+void DiskRecorder::stop()
+{
+	if (!recording.load())
+		return;
+
+	{
+		const SpinLock::ScopedLockType sl(streamLock);
+		recording = false;
+	}
+
+	writerThread.removeTimeSliceClient(this);
+
+	// The writer thread is off the streams now, so what is left is written here.
+	for (auto* stream : streams)
+	{
+		drain(*stream, 0);
+		stream->writer = nullptr;
+	}
+
+	const SpinLock::ScopedLockType sl(streamLock);
+	streams.clear();
+}
+
+//==============================================================================
+void DiskRecorder::push(int stream, const AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+	if (!recording.load())
+		return;
+
+	const SpinLock::ScopedTryLockType sl(streamLock);
+	if (!sl.isLocked())
+	{
+		numOverruns.fetch_add(1);
+		return;
+	}
+
+	auto* s = streams[stream];
+	if (s == nullptr || !recording.load())
+		return;
+
+	if (s->fifo.getFreeSpace() < numSamples)
+	{
+		numOverruns.fetch_add(1);
+		return;
+	}
+
+	int start1, size1, start2, size2;
+	s->fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+	const auto numChannels = s->buffer.getNumChannels();
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		// Mono sources are written to every channel of the file.
+		const auto source = jmin(ch, buffer.getNumChannels() - 1);
+		if (size1 > 0)
+			s->buffer.copyFrom(ch, start1, buffer, source, 0, size1);
+		if (size2 > 0)
+			s->buffer.copyFrom(ch, start2, buffer, source, size1, size2);
+	}
+
+	s->fifo.finishedWrite(size1 + size2);
+}
+
+int DiskRecorder::useTimeSlice()
+{
+	for (auto* stream : streams)
+		drain(*stream, minWriteSamples);
+
+	return 20;
+}
+
+void DiskRecorder::drain(Stream& stream, int minSamples)
+{
+	const auto numReady = stream.fifo.getNumReady();
+	if (numReady == 0 || numReady < minSamples || stream.writer == nullptr)
+		return;
+
+	int start1, size1, start2, size2;
+	stream.fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+	if (size1 > 0)
+		stream.writer->writeFromAudioSampleBuffer(stream.buffer, start1, size1);
+	if (size2 > 0)
+		stream.writer->writeFromAudioSampleBuffer(stream.buffer, start2, size2);
+
+	stream.fifo.finishedRead(size1 + size2);
+}
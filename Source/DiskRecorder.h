@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    DiskRecorder.h
+    Created: 19 Oct 2026 9:52:37pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Records the mixed output, and optionally every instance, to audio files.
+
+    The audio thread only copies each block into a preallocated FIFO per
+    stream; a TimeSliceThread drains them in large chunks into writers with
+    big file buffers. When a FIFO is full, or a recording is being started
+    or stopped at that moment, the block is dropped and counted as an
+    overrun. Nothing the recorder does can make the audio thread wait.
+
+    Stream 0 is the mix, stream i + 1 is instance i.
+*/
+class DiskRecorder : private TimeSliceClient
+{
+public:
+	DiskRecorder();
+	~DiskRecorder();
+
+	//==============================================================================
+	/** The instance files are named after the mix file, e.g. "Take - Instance 3.wav". */
+	bool start(const File& mixFile, double sampleRate, int numChannels, int numInstances);
+	void stop();
+	bool isRecording() const noexcept { return recording.load(); }
+
+	/** Audio thread. */
+	void push(int stream, const AudioBuffer<float>& buffer, int numSamples) noexcept;
+
+	int getNumOverruns() const noexcept { return numOverruns.load(); }
+
+private:
+	//==============================================================================
+	struct Stream
+	{
+		Stream(int capacity, int numChannels) : fifo(capacity), buffer(numChannels, capacity) {}
+
+		AbstractFifo fifo;
+		AudioBuffer<float> buffer;
+		std::unique_ptr<AudioFormatWriter> writer;
+	};
+
+	int useTimeSlice() override;
+	void drain(Stream& stream, int minSamples);
+
+	TimeSliceThread writerThread{ "MicroChromo Recorder" };
+	OwnedArray<Stream> streams;
+	SpinLock streamLock;
+	std::atomic<bool> recording{ false };
+	std::atomic<int> numOverruns{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskRecorder)
+};
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    GlideEngine.cpp
+    Created: 19 Oct 2026 1:47:33pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "GlideEngine.h"
+
+namespace
+{
+	// Rate of the exponential approach; the curve covers 99.3% of the way.
+	constexpr float exponentialRate = 5.0f;
+}
+
+//==============================================================================
+GlideEngine::GlideEngine()
+{
+	reset();
+}
+
+GlideEngine::~GlideEngine()
+{
+}
+
+void GlideEngine::prepare(double sampleRate, int samplesPerBlock)
+{
+	currentSampleRate = sampleRate;
+	preparedBlockSize = jmax(1, samplesPerBlock);
+	setIntervalLimits(2.0f, 50.0f);
+	reset();
+}
+
+void GlideEngine::reset() noexcept
+{
+	for (int v = 0; v < maxVoices; ++v)
+	{
+		startTime[v] = evalTime[v] = nextTime[v] = 0.0;
+		from[v] = range[v] = 0.0f;
+		invDuration[v] = 1.0f;
+		coeffA[v] = 1.0f;
+		coeffB[v] = coeffC[v] = coeffE[v] = expRate[v] = expNorm[v] = 0.0f;
+		position[v] = value[v] = slope[v] = curvature[v] = 0.0f;
+		active[v] = 0;
+	}
+}
+
+void GlideEngine::setIntervalLimits(float minMs, float maxMs) noexcept
+{
+	minIntervalSamples = jmax(1.0f, minMs * 0.001f * (float)currentSampleRate);
+	maxIntervalSamples = jmax(minIntervalSamples, maxMs * 0.001f * (float)currentSampleRate);
+	updateRoundLimit();
+}
+
+void GlideEngine::updateRoundLimit() noexcept
+{
+	// Each round emits at most one point per voice, and a voice's points are
+	// at least the minimum interval apart, so this many rounds cover a block.
+	maxRoundsPerBlock = (int)std::ceil((float)preparedBlockSize / minIntervalSamples) + 1;
+}
+
+void GlideEngine::setCustomShape(float a, float b) noexcept
+{
+	customA = a;
+	customB = b;
+}
+
+//==============================================================================
+void GlideEngine::startGlide(int voice, float fromCents, float toCents, int64 startSample, int durationSamples, Shape shape) noexcept
+{
+	if (!isPositiveAndBelow(voice, maxVoices))
+		return;
+
+	startTime[voice] = nextTime[voice] = (double)startSample;
+	from[voice] = fromCents;
+	range[voice] = toCents - fromCents;
+	invDuration[voice] = 1.0f / (float)jmax(1, durationSamples);
+
+	coeffA[voice] = coeffB[voice] = coeffC[voice] = coeffE[voice] = expRate[voice] = expNorm[voice] = 0.0f;
+
+	switch (shape)
+	{
+		case Shape::exponential:
+			coeffE[voice] = 1.0f;
+			expRate[voice] = exponentialRate;
+			expNorm[voice] = 1.0f / (1.0f - std::exp(-exponentialRate));
+			break;
+		case Shape::custom:
+			coeffA[voice] = customA;
+			coeffB[voice] = customB;
+			coeffC[voice] = 1.0f - customA - customB;
+			break;
+		case Shape::linear:
+		default:
+			coeffA[voice] = 1.0f;
+			break;
+	}
+
+	active[voice] = 1;
+}
+
+void GlideEngine::stopGlide(int voice) noexcept
+{
+	if (isPositiveAndBelow(voice, maxVoices))
+		active[voice] = 0;
+}
+
+//==============================================================================
+void GlideEngine::evaluate() noexcept
+{
+	for (int v = 0; v < maxVoices; ++v)
+	{
+		const auto u = jlimit(0.0f, 1.0f, (float)(evalTime[v] - startTime[v]) * invDuration[v]);
+		const auto a = coeffA[v], b = coeffB[v], c = coeffC[v];
+		const auto k = expRate[v];
+		const auto ex = std::exp(-k * u) * coeffE[v] * expNorm[v];
+
+		const auto s = u * (a + u * (b + u * c)) + (coeffE[v] * expNorm[v] - ex);
+		const auto ds = a + u * (2.0f * b + 3.0f * c * u) + k * ex;
+		const auto d2s = 2.0f * b + 6.0f * c * u - k * k * ex;
+
+		position[v] = u;
+		value[v] = from[v] + range[v] * s;
+		slope[v] = range[v] * ds * invDuration[v];
+		curvature[v] = range[v] * d2s * invDuration[v] * invDuration[v];
+	}
+}
+
+void GlideEngine::scheduleNext(int voice) noexcept
+{
+	const auto endTime = startTime[voice] + 1.0 / (double)invDuration[voice];
+
+	if (position[voice] >= 1.0f || evalTime[voice] >= endTime - 0.5)
+	{
+		active[voice] = 0;
+		return;
+	}
+
+	// The slope term keeps receivers that hold each bend value within the
+	// tolerance; the curvature term covers receivers that smooth between
+	// bends, where the error of a straight segment is |f''| h^2 / 8.
+	auto step = maxIntervalSamples;
+	const auto absSlope = std::abs(slope[voice]);
+	const auto absCurvature = std::abs(curvature[voice]);
+
+	if (absSlope > 1.0e-9f)
+		step = jmin(step, toleranceCents / absSlope);
+	if (absCurvature > 1.0e-12f)
+		step = jmin(step, std::sqrt(8.0f * toleranceCents / absCurvature));
+
+	step = jmax(step, minIntervalSamples);
+	nextTime[voice] = jmin(evalTime[voice] + (double)step, endTime);
+}
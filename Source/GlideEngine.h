@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    GlideEngine.h
+    Created: 19 Oct 2026 1:47:33pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Per-voice pitch curves (in cents), evaluated a block at a time.
+
+    All voices are evaluated together over structure-of-arrays state, so each
+    pass is a straight loop the compiler can vectorise. Instead of emitting a
+    value every sample, each voice schedules its next emission from the local
+    slope and curvature of its curve. The spacing is the largest step that
+    keeps the error within the tolerance, clamped to a minimum and maximum
+    interval. Flat stretches then cost almost nothing and a bend's bandwidth
+    is bounded by the minimum interval.
+*/
+class GlideEngine
+{
+public:
+	static constexpr int maxVoices = 64;
+
+	enum class Shape
+	{
+		linear = 0,
+		exponential,
+		custom
+	};
+
+	//==============================================================================
+	GlideEngine();
+	~GlideEngine();
+
+	void prepare(double sampleRate, int samplesPerBlock);
+	void reset() noexcept;
+
+	void setToleranceCents(float cents) noexcept { toleranceCents = jmax(0.01f, cents); }
+	void setIntervalLimits(float minMs, float maxMs) noexcept;
+
+	/** The custom shape is the cubic a*u + b*u^2 + (1 - a - b)*u^3 over u in [0, 1]. */
+	void setCustomShape(float a, float b) noexcept;
+
+	//==============================================================================
+	void startGlide(int voice, float fromCents, float toCents, int64 startSample, int durationSamples, Shape shape) noexcept;
+	void stopGlide(int voice) noexcept;
+	bool isGliding(int voice) const noexcept { return active[voice] != 0; }
+
+	/** Calls emit (voice, samplePositionInBlock, cents) for every point due within the block. */
+	template <typename EmitFunction>
+	void render(int64 blockStart, int numSamples, EmitFunction&& emit) noexcept
+	{
+		const auto blockEnd = (double)(blockStart + numSamples);
+
+		for (int round = 0; round < maxRoundsPerBlock; ++round)
+		{
+			auto anyDue = false;
+			for (int v = 0; v < maxVoices; ++v)
+			{
+				const auto due = active[v] != 0 && nextTime[v] < blockEnd;
+				evalTime[v] = due ? nextTime[v] : -1.0;
+				anyDue = anyDue || due;
+			}
+
+			if (!anyDue)
+				break;
+
+			evaluate();
+
+			for (int v = 0; v < maxVoices; ++v)
+			{
+				if (evalTime[v] < 0.0)
+					continue;
+
+				emit(v, jlimit(0, numSamples - 1, (int)(evalTime[v] - (double)blockStart)), value[v]);
+				scheduleNext(v);
+			}
+		}
+	}
+
+private:
+	//==============================================================================
+	void evaluate() noexcept;
+	void scheduleNext(int voice) noexcept;
+
+	void updateRoundLimit() noexcept;
+
+	// Curve parameters; pitch (t) = from + range * shape (u), u = (t - start) / duration,
+	// shape (u) = a*u + b*u^2 + c*u^3 + e * (1 - exp (-k u)) * norm
+	alignas(32) double startTime[maxVoices];
+	alignas(32) double evalTime[maxVoices];
+	alignas(32) double nextTime[maxVoices];
+	alignas(32) float from[maxVoices];
+	alignas(32) float range[maxVoices];
+	alignas(32) float invDuration[maxVoices];
+	alignas(32) float coeffA[maxVoices];
+	alignas(32) float coeffB[maxVoices];
+	alignas(32) float coeffC[maxVoices];
+	alignas(32) float coeffE[maxVoices];
+	alignas(32) float expRate[maxVoices];
+	alignas(32) float expNorm[maxVoices];
+
+	// Evaluation results
+	alignas(32) float position[maxVoices];
+	alignas(32) float value[maxVoices];
+	alignas(32) float slope[maxVoices];
+	alignas(32) float curvature[maxVoices];
+
+	uint8 active[maxVoices];
+
+	float customA = 0.0f, customB = 3.0f;
+	float toleranceCents = 1.0f;
+	float minIntervalSamples = 96.0f, maxIntervalSamples = 2400.0f;
+	double currentSampleRate = 48000.0;
+	int preparedBlockSize = 512, maxRoundsPerBlock = 7;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GlideEngine)
+};
@@ -0,0 +1,319 @@
+/*
+  ==============================================================================
+
+    GraphHistory.cpp
+    Created: 19 Oct 2026 7:02:51pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "GraphHistory.h"
+
+namespace
+{
+	// UndoManager units are bytes here: old steps are dropped past
+	// maxHistoryBytes, but the last few are always kept however large they are.
+	constexpr int minHistorySteps = 10;
+	constexpr int bytesPerSnapshot = (int)sizeof(GraphHistory::Snapshot) + 64;
+
+	size_t getBlobBytes(const std::shared_ptr<const Array<GraphHistory::Blob>>& states)
+	{
+		size_t total = 0;
+		if (states != nullptr)
+			for (auto& blob : *states)
+				if (blob != nullptr)
+					total += blob->getSize();
+		return total;
+	}
+}
+
+//==============================================================================
+bool GraphHistory::Topology::operator==(const Topology& other) const
+{
+	return hasSameInstances(other)
+		&& mpeLowerZone == other.mpeLowerZone && mpeNumMemberChannels == other.mpeNumMemberChannels
+		&& mpePitchbendRange == other.mpePitchbendRange && lookaheadSamples == other.lookaheadSamples
+		&& adaptiveTuning == other.adaptiveTuning && adaptiveDriftCents == other.adaptiveDriftCents;
+}
+
+bool GraphHistory::Topology::hasSameInstances(const Topology& other) const
+{
+	if (numInstances != other.numInstances || outputMode != other.outputMode || sandboxed != other.sandboxed)
+		return false;
+
+	if (backend == nullptr || other.backend == nullptr)
+		return backend == other.backend;
+
+	return backend->isDuplicateOf(*other.backend);
+}
+
+ValueTree GraphHistory::Topology::toValueTree() const
+{
+	ValueTree tree("Topology");
+	tree.setProperty("numInstances", numInstances, nullptr);
+	tree.setProperty("outputMode", (int)outputMode, nullptr);
+	tree.setProperty("mpeLowerZone", mpeLowerZone, nullptr);
+	tree.setProperty("mpeNumMemberChannels", mpeNumMemberChannels, nullptr);
+	tree.setProperty("mpePitchbendRange", mpePitchbendRange, nullptr);
+	tree.setProperty("lookaheadSamples", lookaheadSamples, nullptr);
+	tree.setProperty("sandboxed", sandboxed, nullptr);
+	tree.setProperty("adaptiveTuning", adaptiveTuning, nullptr);
+	tree.setProperty("adaptiveDriftCents", adaptiveDriftCents, nullptr);
+
+	if (backend != nullptr)
+		if (auto xml = std::unique_ptr<XmlElement>(backend->createXml()))
+			tree.appendChild(ValueTree::fromXml(*xml), nullptr);
+
+	return tree;
+}
+
+GraphHistory::Topology GraphHistory::Topology::fromValueTree(const ValueTree& tree)
+{
+	Topology topology;
+	topology.numInstances = tree.getProperty("numInstances", 1);
+	topology.outputMode = (MidiRouter::OutputMode)(int)tree.getProperty("outputMode", 0);
+	topology.mpeLowerZone = tree.getProperty("mpeLowerZone", true);
+	topology.mpeNumMemberChannels = tree.getProperty("mpeNumMemberChannels", 15);
+	topology.mpePitchbendRange = tree.getProperty("mpePitchbendRange", 48);
+	topology.lookaheadSamples = tree.getProperty("lookaheadSamples", 0);
+	topology.sandboxed = tree.getProperty("sandboxed", false);
+	topology.adaptiveTuning = tree.getProperty("adaptiveTuning", false);
+	topology.adaptiveDriftCents = tree.getProperty("adaptiveDriftCents", 20.0f);
+
+	if (tree.getNumChildren() > 0)
+	{
+		PluginDescription description;
+		if (auto xml = std::unique_ptr<XmlElement>(tree.getChild(0).createXml()))
+			if (description.loadFromXml(*xml))
+				topology.backend.reset(new PluginDescription(description));
+	}
+
+	return topology;
+}
+
+bool GraphHistory::Glide::operator==(const Glide& other) const
+{
+	return retuneMs == other.retuneMs && portamentoMs == other.portamentoMs && shape == other.shape;
+}
+
+ValueTree GraphHistory::Glide::toValueTree() const
+{
+	ValueTree tree("Glide");
+	tree.setProperty("retuneMs", retuneMs, nullptr);
+	tree.setProperty("portamentoMs", portamentoMs, nullptr);
+	tree.setProperty("shape", (int)shape, nullptr);
+	return tree;
+}
+
+GraphHistory::Glide GraphHistory::Glide::fromValueTree(const ValueTree& tree)
+{
+	Glide glide;
+	glide.retuneMs = tree.getProperty("retuneMs", 0.0f);
+	glide.portamentoMs = tree.getProperty("portamentoMs", 0.0f);
+	glide.shape = (GlideEngine::Shape)(int)tree.getProperty("shape", 0);
+	return glide;
+}
+
+//==============================================================================
+class GraphHistory::EditAction : public UndoableAction
+{
+public:
+	EditAction(GraphHistory& o, std::shared_ptr<Snapshot> beforeToUse, std::shared_ptr<Snapshot> afterToUse, int sizeToUse)
+		: owner(o), before(std::move(beforeToUse)), after(std::move(afterToUse)), size(sizeToUse)
+	{
+	}
+
+	bool perform() override
+	{
+		// The edit has already been made when the step is recorded.
+		if (firstPerform)
+		{
+			firstPerform = false;
+			return true;
+		}
+
+		owner.restore(after);
+		return true;
+	}
+
+	bool undo() override
+	{
+		owner.restore(before);
+		return true;
+	}
+
+	// The UndoManager adds this when the step is performed and takes it off
+	// again when the step is dropped, so it must never change in between.
+	int getSizeInUnits() override { return size; }
+
+private:
+	GraphHistory& owner;
+	const std::shared_ptr<Snapshot> before, after;
+	const int size;
+	bool firstPerform = true;
+};
+
+//==============================================================================
+GraphHistory::GraphHistory(std::function<void(const Snapshot&)> restoreCallback)
+	: onRestore(std::move(restoreCallback)),
+	  current(std::make_shared<Snapshot>()),
+	  undoManager(maxHistoryBytes, minHistorySteps)
+{
+	reset({}, {}, {});
+}
+
+GraphHistory::~GraphHistory()
+{
+	undoManager.clearUndoHistory();
+}
+
+void GraphHistory::reset(Topology topology, const Array<float>& tuning, const Glide& glide)
+{
+	undoManager.clearUndoHistory();
+	refreshed = nullptr;
+
+	auto snapshot = std::make_shared<Snapshot>();
+	snapshot->topology = std::make_shared<const Topology>(std::move(topology));
+	snapshot->tuning = std::make_shared<const Array<float>>(tuning);
+	snapshot->glide = std::make_shared<const Glide>(glide);
+	current = snapshot;
+
+	purgeExpiredBlobs();
+}
+
+void GraphHistory::commit(const String& name, Topology topology, const Array<float>& tuning, const Glide& glide)
+{
+	// States recorded since the current snapshot was reached go into a copy
+	// of it, which becomes the point this step undoes to.
+	auto previous = current;
+	if (refreshed != nullptr && isSamePoint(*refreshed, *current))
+		previous = refreshed;
+
+	auto next = std::make_shared<Snapshot>(*previous);
+	auto changed = false;
+
+	if (topology != *current->topology)
+	{
+		// The graph was rebuilt: the new instances start from their defaults.
+		if (!topology.hasSameInstances(*current->topology))
+			next->nodeStates = nullptr;
+
+		next->topology = std::make_shared<const Topology>(std::move(topology));
+		changed = true;
+	}
+
+	if (tuning != *current->tuning)
+	{
+		next->tuning = std::make_shared<const Array<float>>(tuning);
+		changed = true;
+	}
+
+	if (!(glide == *current->glide))
+	{
+		next->glide = std::make_shared<const Glide>(glide);
+		changed = true;
+	}
+
+	if (!changed)
+		return;
+
+	// Only what this step does not share with the step before it.
+	size_t size = bytesPerSnapshot;
+	if (previous != current)
+		size += bytesPerSnapshot + getBlobBytes(previous->nodeStates);
+	if (next->tuning != previous->tuning)
+		size += sizeof(float) * (size_t)next->tuning->size();
+	if (next->nodeStates != previous->nodeStates)
+		size += getBlobBytes(next->nodeStates);
+
+	if (previous != current)
+		refreshed = nullptr;
+
+	current = next;
+
+	undoManager.beginNewTransaction(name);
+	undoManager.perform(new EditAction(*this, previous, next, (int)jmin(size, (size_t)maxHistoryBytes)));
+	purgeExpiredBlobs();
+}
+
+void GraphHistory::refreshNodeStates(const Array<MemoryBlock>& states)
+{
+	Array<Blob> interned;
+	interned.ensureStorageAllocated(states.size());
+
+	for (auto& state : states)
+		interned.add(intern(state));
+
+	const auto known = refreshed != nullptr && isSamePoint(*refreshed, *current)
+		? refreshed->nodeStates : current->nodeStates;
+
+	if (known != nullptr && *known == interned)
+		return;
+
+	// Snapshots already in a step are left alone, so the step's size stays
+	// what it was counted as; the states wait in a copy for commit() or restore().
+	refreshed = std::make_shared<Snapshot>(*current);
+	refreshed->nodeStates = std::make_shared<const Array<Blob>>(std::move(interned));
+}
+
+void GraphHistory::restore(const std::shared_ptr<Snapshot>& snapshot)
+{
+	// Coming back to where states were last recorded brings those back.
+	const auto target = refreshed != nullptr && isSamePoint(*refreshed, *snapshot) ? refreshed : snapshot;
+
+	// A rebuild in here records the states of the snapshot being left.
+	onRestore(*target);
+	current = snapshot;
+}
+
+bool GraphHistory::isSamePoint(const Snapshot& a, const Snapshot& b) noexcept
+{
+	return a.topology == b.topology && a.tuning == b.tuning && a.glide == b.glide;
+}
+
+//==============================================================================
+GraphHistory::Blob GraphHistory::intern(const MemoryBlock& data)
+{
+	if (data.getSize() == 0)
+		return nullptr;
+
+	const auto key = SHA256(data).toHexString();
+
+	auto& entry = blobs[key];
+	if (auto existing = entry.lock())
+		return existing;
+
+	auto blob = std::make_shared<const MemoryBlock>(data);
+	entry = blob;
+	return blob;
+}
+
+int GraphHistory::getNumBlobs() const
+{
+	int count = 0;
+	for (auto& entry : blobs)
+		if (!entry.second.expired())
+			++count;
+	return count;
+}
+
+size_t GraphHistory::getNumBlobBytes() const
+{
+	size_t total = 0;
+	for (auto& entry : blobs)
+		if (auto blob = entry.second.lock())
+			total += blob->getSize();
+	return total;
+}
+
+void GraphHistory::purgeExpiredBlobs()
+{
+	for (auto it = blobs.begin(); it != blobs.end();)
+	{
+		if (it->second.expired())
+			it = blobs.erase(it);
+		else
+			++it;
+	}
+}
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    GraphHistory.h
+    Created: 19 Oct 2026 7:02:51pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MidiRouter.h"
+
+//==============================================================================
+/**
+    Undo history for edits to the hosted graph.
+
+    A snapshot is a handful of pointers to immutable parts: topology, tuning,
+    glide settings and the saved state of every backend instance. A new
+    snapshot shares every part the edit did not touch with the one before,
+    so a step costs what it changed. Backend state blobs are interned by
+    content hash and only held weakly by the store, so identical states are
+    kept once and are freed with the last snapshot using them.
+
+    The steps themselves live in an UndoManager whose size limit counts
+    bytes, which keeps memory bounded however many edits are made. A step's
+    size is counted once, when it is committed, so snapshots in a step are
+    never changed afterwards. Instance states recorded later are held aside,
+    one set at a time, until the next step or a return to the same point.
+*/
+class GraphHistory
+{
+public:
+	using Blob = std::shared_ptr<const MemoryBlock>;
+
+	struct Topology
+	{
+		int numInstances = 1;
+		MidiRouter::OutputMode outputMode = MidiRouter::OutputMode::clones;
+		bool mpeLowerZone = true;
+		int mpeNumMemberChannels = 15, mpePitchbendRange = 48;
+		int lookaheadSamples = 0;
+		bool sandboxed = false;
+		bool adaptiveTuning = false;
+		float adaptiveDriftCents = 20.0f;
+		std::unique_ptr<PluginDescription> backend;
+
+		bool operator==(const Topology& other) const;
+		bool operator!=(const Topology& other) const { return !operator==(other); }
+
+		/** True if going from one to the other keeps the instances; the rest only changes the routing. */
+		bool hasSameInstances(const Topology& other) const;
+
+		ValueTree toValueTree() const;
+		static Topology fromValueTree(const ValueTree& tree);
+	};
+
+	struct Glide
+	{
+		float retuneMs = 0.0f, portamentoMs = 0.0f;
+		GlideEngine::Shape shape = GlideEngine::Shape::linear;
+
+		bool operator==(const Glide& other) const;
+
+		ValueTree toValueTree() const;
+		static Glide fromValueTree(const ValueTree& tree);
+	};
+
+	struct Snapshot
+	{
+		std::shared_ptr<const Topology> topology;
+		std::shared_ptr<const Array<float>> tuning;
+		std::shared_ptr<const Glide> glide;
+
+		/** Null until the instances have been saved, e.g. right after a rebuild. */
+		std::shared_ptr<const Array<Blob>> nodeStates;
+	};
+
+	//==============================================================================
+	GraphHistory(std::function<void(const Snapshot&)> restoreCallback);
+	~GraphHistory();
+
+	/** Drops all steps and starts again from the given settings. */
+	void reset(Topology topology, const Array<float>& tuning, const Glide& glide);
+
+	/** Adds a step if anything differs from the current snapshot. */
+	void commit(const String& name, Topology topology, const Array<float>& tuning, const Glide& glide);
+
+	/** Records the current state of the instances, without adding a step.
+
+	    The states go into the next step committed from here, or come back
+	    when undo or redo returns here.
+	*/
+	void refreshNodeStates(const Array<MemoryBlock>& states);
+
+	const Snapshot& getCurrent() const noexcept { return *current; }
+	UndoManager& getUndoManager() noexcept { return undoManager; }
+
+	bool undo() { return undoManager.undo(); }
+	bool redo() { return undoManager.redo(); }
+
+	static constexpr int maxHistoryBytes = 64 * 1024 * 1024;
+
+	//==============================================================================
+	Blob intern(const MemoryBlock& data);
+	int getNumBlobs() const;
+	size_t getNumBlobBytes() const;
+
+private:
+	//==============================================================================
+	class EditAction;
+
+	void restore(const std::shared_ptr<Snapshot>& snapshot);
+	void purgeExpiredBlobs();
+
+	/** True if both stand for the same edit, whatever their instance states. */
+	static bool isSamePoint(const Snapshot& a, const Snapshot& b) noexcept;
+
+	std::function<void(const Snapshot&)> onRestore;
+	std::shared_ptr<Snapshot> current;
+
+	/** The current point again, with the instance states recorded since; null if there are none. */
+	std::shared_ptr<Snapshot> refreshed;
+	std::map<String, std::weak_ptr<const MemoryBlock>> blobs;
+	UndoManager undoManager;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GraphHistory)
+};
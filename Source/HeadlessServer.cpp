@@ -0,0 +1,567 @@
+/*
+  ==============================================================================
+
+    HeadlessServer.cpp
+    Created: 19 Oct 2026 11:52:19pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "HeadlessServer.h"
+#include "PluginProcessor.h"
+#include <iostream>
+
+const char* const HeadlessServer::commandLineFlag = "--headless";
+
+namespace
+{
+	String getOptionValue(const StringArray& args, const String& name)
+	{
+		const auto index = args.indexOf(name);
+		return index >= 0 ? args[index + 1] : String();
+	}
+
+	File resolveFile(const String& path)
+	{
+		return File::getCurrentWorkingDirectory().getChildFile(path.trim().unquoted());
+	}
+
+	int parseByte(const String& token)
+	{
+		return token.startsWithIgnoreCase("0x") ? token.substring(2).getHexValue32() : token.getIntValue();
+	}
+}
+
+//==============================================================================
+/** Single producer, single consumer queue of short MIDI messages. */
+class HeadlessServer::MidiQueue
+{
+public:
+	MidiQueue()
+	{
+		zeromem(bytes, sizeof(bytes));
+		zeromem(sizes, sizeof(sizes));
+	}
+
+	/** Messages longer than three bytes, i.e. SysEx, are not passed on. */
+	bool push(const uint8* data, int numBytes) noexcept
+	{
+		if (numBytes < 1 || numBytes > 3)
+			return false;
+
+		int start1, size1, start2, size2;
+		fifo.prepareToWrite(1, start1, size1, start2, size2);
+		if (size1 == 0)
+			return false;
+
+		memcpy(bytes[start1], data, (size_t)numBytes);
+		sizes[start1] = (uint8)numBytes;
+		fifo.finishedWrite(1);
+		return true;
+	}
+
+	void drainInto(MidiBuffer& dest) noexcept
+	{
+		int start1, size1, start2, size2;
+		fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+		for (int i = 0; i < size1; ++i)
+			dest.addEvent(bytes[start1 + i], sizes[start1 + i], 0);
+		for (int i = 0; i < size2; ++i)
+			dest.addEvent(bytes[start2 + i], sizes[start2 + i], 0);
+
+		fifo.finishedRead(size1 + size2);
+	}
+
+private:
+	static constexpr int capacity = 1024;
+	AbstractFifo fifo{ capacity };
+	uint8 bytes[capacity][3];
+	uint8 sizes[capacity];
+};
+
+//==============================================================================
+/** Feeds the processor from an audio device, or from the clock thread when there is none. */
+class HeadlessServer::AudioEngine : public AudioIODeviceCallback,
+                                    public MidiInputCallback
+{
+public:
+	AudioEngine(MicroChromoAudioProcessor& p) : processor(p) {}
+
+	void prepare(double sampleRate, int samplesPerBlock)
+	{
+		processor.setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+		processor.prepareToPlay(sampleRate, samplesPerBlock);
+
+		buffer.setSize(jmax(1, processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels()), samplesPerBlock);
+		midi.ensureSize(2048 * 3);
+	}
+
+	/** Renders numSamples into the internal buffer, reading the inputs first if there are any. */
+	AudioBuffer<float>* render(const float** inputs, int numInputs, int numSamples) noexcept
+	{
+		if (numSamples > buffer.getNumSamples())
+			return nullptr;
+
+		midi.clear();
+		controlMidi.drainInto(midi);
+		deviceMidi.drainInto(midi);
+
+		block.setDataToReferTo(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+		block.clear();
+
+		for (int ch = 0; ch < jmin(numInputs, processor.getTotalNumInputChannels()); ++ch)
+			if (inputs[ch] != nullptr)
+				block.copyFrom(ch, 0, inputs[ch], numSamples);
+
+		// Commands that rebuild the graph suspend the processor, holding its
+		// callback lock meanwhile; the block is silent rather than waiting.
+		const ScopedTryLock sl(processor.getCallbackLock());
+		if (sl.isLocked() && !processor.isSuspended())
+			processor.processBlock(block, midi);
+		else
+			block.clear();
+
+		return &block;
+	}
+
+	//==============================================================================
+	void audioDeviceIOCallback(const float** inputs, int numInputs, float** outputs, int numOutputs, int numSamples) override
+	{
+		auto* rendered = render(inputs, numInputs, numSamples);
+		const auto numMainOutputs = processor.getMainBusNumOutputChannels();
+
+		for (int ch = 0; ch < numOutputs; ++ch)
+		{
+			if (outputs[ch] == nullptr)
+				continue;
+
+			if (rendered != nullptr && ch < numMainOutputs)
+				FloatVectorOperations::copy(outputs[ch], rendered->getReadPointer(ch), numSamples);
+			else
+				FloatVectorOperations::clear(outputs[ch], numSamples);
+		}
+	}
+
+	void audioDeviceAboutToStart(AudioIODevice* device) override
+	{
+		prepare(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
+	}
+
+	void audioDeviceStopped() override
+	{
+		processor.releaseResources();
+	}
+
+	void handleIncomingMidiMessage(MidiInput*, const MidiMessage& message) override
+	{
+		deviceMidi.push(message.getRawData(), message.getRawDataSize());
+	}
+
+	/** Filled by the message thread only. */
+	MidiQueue controlMidi;
+
+private:
+	MicroChromoAudioProcessor& processor;
+	AudioBuffer<float> buffer, block;
+	MidiBuffer midi;
+	MidiQueue deviceMidi;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
+};
+
+//==============================================================================
+/** Stands in for the audio device, rendering one block per block duration. */
+class HeadlessServer::ClockThread : public Thread
+{
+public:
+	ClockThread(AudioEngine& e, double rate, int block)
+		: Thread("MicroChromo Clock"), engine(e), sampleRate(rate), blockSize(block)
+	{
+	}
+
+	~ClockThread() override
+	{
+		stopThread(2000);
+	}
+
+	void run() override
+	{
+		const auto blockMs = blockSize * 1000.0 / sampleRate;
+		auto next = Time::getMillisecondCounterHiRes();
+
+		while (!threadShouldExit())
+		{
+			engine.render(nullptr, 0, blockSize);
+			next += blockMs;
+
+			// After a long stall, carry on from now instead of rushing to catch up.
+			const auto waitMs = next - Time::getMillisecondCounterHiRes();
+			if (waitMs > 1.0)
+				wait((int)waitMs);
+			else if (waitMs < -8.0 * blockMs)
+				next = Time::getMillisecondCounterHiRes();
+		}
+	}
+
+private:
+	AudioEngine& engine;
+	const double sampleRate;
+	const int blockSize;
+};
+
+//==============================================================================
+/** Reads datagrams and queues them for the message thread. */
+class HeadlessServer::ControlThread : public Thread
+{
+public:
+	ControlThread(HeadlessServer& o) : Thread("MicroChromo Control"), owner(o) {}
+
+	~ControlThread() override
+	{
+		signalThreadShouldExit();
+		socket.shutdown();
+		stopThread(2000);
+	}
+
+	bool bind(int port)
+	{
+		return socket.bindToPort(port, "127.0.0.1");
+	}
+
+	void send(const String& address, int port, const String& text)
+	{
+		socket.write(address, port, text.toRawUTF8(), (int)text.getNumBytesAsUTF8());
+	}
+
+	void run() override
+	{
+		HeapBlock<char> data(maxDatagramSize);
+
+		while (!threadShouldExit())
+		{
+			if (socket.waitUntilReady(true, 100) != 1)
+				continue;
+
+			Command command;
+			const auto numBytes = socket.read(data, maxDatagramSize, false, command.senderAddress, command.senderPort);
+			if (numBytes <= 0)
+				continue;
+
+			command.text = String::fromUTF8(data, numBytes).trim();
+			if (command.text.isEmpty())
+				continue;
+
+			int start1, size1, start2, size2;
+			owner.commandFifo.prepareToWrite(1, start1, size1, start2, size2);
+			if (size1 == 0)
+			{
+				send(command.senderAddress, command.senderPort, "error: busy");
+				continue;
+			}
+
+			owner.commands[start1] = command;
+			owner.commandFifo.finishedWrite(1);
+			owner.triggerAsyncUpdate();
+		}
+	}
+
+private:
+	static constexpr int maxDatagramSize = 4096;
+
+	HeadlessServer& owner;
+	DatagramSocket socket;
+};
+
+//==============================================================================
+HeadlessServer::HeadlessServer(const String& commandLine)
+{
+	auto args = StringArray::fromTokens(commandLine, true);
+	for (auto& arg : args)
+		arg = arg.unquoted();
+
+	if (args.contains("--port"))
+		port = jlimit(1, 65535, getOptionValue(args, "--port").getIntValue());
+	if (args.contains("--device"))
+		deviceName = getOptionValue(args, "--device");
+	if (args.contains("--rate"))
+		sampleRate = jmax(8000.0, getOptionValue(args, "--rate").getDoubleValue());
+	if (args.contains("--block"))
+		blockSize = jlimit(16, 8192, getOptionValue(args, "--block").getIntValue());
+}
+
+HeadlessServer::~HeadlessServer()
+{
+	cancelPendingUpdate();
+	control = nullptr;
+	clock = nullptr;
+
+	if (engine != nullptr)
+	{
+		for (auto& input : MidiInput::getDevices())
+			deviceManager.removeMidiInputCallback(input, engine.get());
+		deviceManager.removeAudioCallback(engine.get());
+		deviceManager.closeAudioDevice();
+	}
+
+	if (processor != nullptr)
+		processor->stopRecording();
+
+	engine = nullptr;
+	processor = nullptr;
+}
+
+bool HeadlessServer::start(String& error)
+{
+	processor.reset(new MicroChromoAudioProcessor());
+	processor->setAutosaveEnabled(false);
+	engine.reset(new AudioEngine(*processor));
+
+	SharedResourcePointer<PluginDatabase> database;
+	database->loadAsync();
+
+	control.reset(new ControlThread(*this));
+	if (!control->bind(port))
+	{
+		error = "cannot listen on port " + String(port);
+		return false;
+	}
+
+	if (deviceName == "none")
+	{
+		engine->prepare(sampleRate, blockSize);
+		clock.reset(new ClockThread(*engine, sampleRate, blockSize));
+		clock->startThread(Thread::realtimeAudioPriority);
+	}
+	else
+	{
+		AudioDeviceManager::AudioDeviceSetup setup;
+		setup.outputDeviceName = deviceName;
+		setup.sampleRate = sampleRate;
+		setup.bufferSize = blockSize;
+
+		const auto result = deviceManager.initialise(processor->getTotalNumInputChannels(), processor->getMainBusNumOutputChannels(),
+			nullptr, true, deviceName, deviceName.isNotEmpty() ? &setup : nullptr);
+		if (result.isNotEmpty())
+		{
+			error = result;
+			return false;
+		}
+
+		for (auto& input : MidiInput::getDevices())
+		{
+			deviceManager.setMidiInputEnabled(input, true);
+			deviceManager.addMidiInputCallback(input, engine.get());
+		}
+
+		deviceManager.addAudioCallback(engine.get());
+	}
+
+	control->startThread();
+	std::cout << "Listening for commands on 127.0.0.1:" << port << std::endl;
+	return true;
+}
+
+//==============================================================================
+void HeadlessServer::handleAsyncUpdate()
+{
+	while (commandFifo.getNumReady() > 0)
+	{
+		int start1, size1, start2, size2;
+		commandFifo.prepareToRead(1, start1, size1, start2, size2);
+		const auto command = commands[start1];
+		commands[start1] = Command();
+		commandFifo.finishedRead(1);
+
+		if (command.text.equalsIgnoreCase("quit"))
+		{
+			reply(command, "ok");
+			JUCEApplicationBase::quit();
+			return;
+		}
+
+		reply(command, execute(command.text));
+	}
+}
+
+void HeadlessServer::reply(const Command& command, const String& text)
+{
+	if (control != nullptr)
+		control->send(command.senderAddress, command.senderPort, text);
+}
+
+String HeadlessServer::execute(const String& command)
+{
+	const auto tokens = StringArray::fromTokens(command, true);
+	const auto verb = tokens[0].toLowerCase();
+	const auto argument = command.fromFirstOccurrenceOf(tokens[0], false, false).trim();
+
+	if (verb == "load")
+	{
+		if (argument.equalsIgnoreCase("reference"))
+		{
+			processor->useReferenceBackend();
+			return "ok";
+		}
+		return loadPlugin(argument.unquoted());
+	}
+
+	if (verb == "instances")
+	{
+		processor->setNumInstances(argument.getIntValue());
+		return "ok";
+	}
+
+	if (verb == "tuning")
+	{
+		const auto file = resolveFile(argument);
+		if (!file.existsAsFile())
+			return "error: cannot read " + file.getFullPathName();
+
+		processor->setNoteOffsets(MicroChromoAudioProcessor::loadTuningFile(file));
+		return "ok";
+	}
+
+	if (verb == "adaptive")
+	{
+		const auto drift = tokens.size() > 2 ? tokens[2].getFloatValue() : 20.0f;
+		processor->setAdaptiveTuning(tokens[1].equalsIgnoreCase("on"), drift);
+		return "ok";
+	}
+
+	if (verb == "preset")
+	{
+		MemoryBlock state;
+		const auto file = resolveFile(argument);
+		if (!file.loadFileAsData(state))
+			return "error: cannot read " + file.getFullPathName();
+
+		processor->setStateInformation(state.getData(), (int)state.getSize());
+		return "ok";
+	}
+
+	if (verb == "program")
+	{
+		const auto index = argument.getIntValue();
+		if (!isPositiveAndBelow(index, processor->getProgramBank().getNumPrograms()))
+			return "error: no program " + argument;
+
+		processor->setCurrentProgram(index);
+		return "ok";
+	}
+
+	if (verb == "record")
+	{
+		const auto includeInstances = tokens.size() > 2 && tokens[tokens.size() - 1].equalsIgnoreCase("instances");
+		const auto path = includeInstances ? argument.upToLastOccurrenceOf("instances", false, true) : argument;
+		const auto file = resolveFile(path);
+
+		return processor->startRecording(file, includeInstances) ? "ok" : "error: cannot write " + file.getFullPathName();
+	}
+
+	if (verb == "stop-record")
+	{
+		processor->stopRecording();
+		return "ok";
+	}
+
+	if (verb == "midi")
+	{
+		uint8 data[3];
+		const auto numBytes = jmin(3, tokens.size() - 1);
+		for (int i = 0; i < numBytes; ++i)
+			data[i] = (uint8)jlimit(0, 255, parseByte(tokens[i + 1]));
+
+		if (numBytes == 0 || (data[0] & 0x80) == 0)
+			return "error: expected a status byte";
+
+		return engine->controlMidi.push(data, numBytes) ? "ok" : "error: MIDI queue full";
+	}
+
+	if (verb == "stats")
+		return getStats();
+
+	if (verb == "clear-isolation")
+	{
+		processor->clearIsolation();
+		return "ok";
+	}
+
+	return "error: unknown command " + tokens[0];
+}
+
+String HeadlessServer::loadPlugin(const String& nameOrFile)
+{
+	SharedResourcePointer<PluginDatabase> database;
+
+	if (database->isLoaded())
+	{
+		auto& list = database->getKnownPluginList();
+		for (int i = 0; i < list.getNumTypes(); ++i)
+		{
+			auto* type = list.getType(i);
+			if (type->name.equalsIgnoreCase(nameOrFile) || type->fileOrIdentifier == nameOrFile
+				|| type->createIdentifierString() == nameOrFile)
+			{
+				processor->setBackend(*type);
+				return "ok";
+			}
+		}
+	}
+
+	// Not in the list, or the list is still loading: try it as a plugin file.
+	auto& formats = database->getFormatManager();
+	for (int i = 0; i < formats.getNumFormats(); ++i)
+	{
+		OwnedArray<PluginDescription> found;
+		formats.getFormat(i)->findAllTypesForFile(found, nameOrFile);
+
+		if (!found.isEmpty())
+		{
+			processor->setBackend(*found.getFirst());
+			return "ok";
+		}
+	}
+
+	return "error: no plugin " + nameOrFile;
+}
+
+String HeadlessServer::getStats() const
+{
+	const auto& governor = processor->getLoadGovernor();
+	const auto& recorder = processor->getRecorder();
+
+	DynamicObject::Ptr stats(new DynamicObject());
+	stats->setProperty("load", governor.getLoad());
+	stats->setProperty("peakLoad", governor.getPeakLoad());
+	stats->setProperty("overruns", governor.getNumOverruns());
+	stats->setProperty("loadLevel", (int)governor.getLevel());
+	stats->setProperty("latency", processor->getLatencySamples());
+	stats->setProperty("recording", recorder.isRecording());
+	stats->setProperty("recorderOverruns", recorder.getNumOverruns());
+
+	const auto& idle = processor->getIdlePolicy();
+	stats->setProperty("idleTier", (int)idle.getTier());
+	stats->setProperty("lastResumedTier", (int)idle.getLastResumedTier());
+	stats->setProperty("lastResumeMs", idle.getLastResumeMs());
+
+	Array<var> instances;
+	for (int i = 0; i < processor->getNumInstances(); ++i)
+	{
+		auto* instance = processor->getInstanceProcessor(i);
+		if (instance == nullptr)
+			break;
+
+		DynamicObject::Ptr counters(new DynamicObject());
+		counters->setProperty("nonFiniteBlocks", instance->getNumNonFiniteBlocks());
+		counters->setProperty("denormalBlocks", instance->getNumDenormalBlocks());
+		counters->setProperty("silentBlocks", instance->getNumSilentBlocks());
+		counters->setProperty("sleptBlocks", instance->getNumSleptBlocks());
+		counters->setProperty("isolated", instance->isIsolated());
+		instances.add(var(counters.get()));
+	}
+	stats->setProperty("instances", instances);
+
+	return JSON::toString(var(stats.get()), true);
+}
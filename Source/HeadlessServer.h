@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    HeadlessServer.h
+    Created: 19 Oct 2026 11:52:19pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class MicroChromoAudioProcessor;
+
+//==============================================================================
+/**
+    Runs the processor without a window, driven by text commands over UDP on
+    the loopback interface.
+
+    Audio goes to an audio device, or with "--device none" to nothing: a
+    clock thread then renders block by block at real-time pace, which is
+    enough for recording on machines without a sound card.
+
+    Commands are datagrams of one line each, and every command gets a
+    one-line reply to the address it came from, "ok", "error: ..." or the
+    requested data:
+
+        load <plugin name, identifier or file> | load reference
+        instances <n>
+        tuning <file>            adaptive on|off [drift cents]
+        preset <file>            program <index>
+        record <file> [instances]
+        stop-record
+        midi <status> <data1> [data2]
+        stats                    clear-isolation
+        quit
+
+    The socket is read on its own thread, which only queues the commands.
+    The message thread runs them, as the processor expects. MIDI sent with
+    "midi" reaches the audio thread through a lock-free FIFO, the same way
+    as MIDI from the connected input devices, so neither can make the audio
+    thread wait.
+*/
+class HeadlessServer : private AsyncUpdater
+{
+public:
+	HeadlessServer(const String& commandLine);
+	~HeadlessServer();
+
+	/** Opens the socket and starts the audio; returns false, with a reason, if either fails. */
+	bool start(String& error);
+
+	static const char* const commandLineFlag;
+	static constexpr int defaultPort = 9010;
+
+private:
+	//==============================================================================
+	struct Command
+	{
+		String text, senderAddress;
+		int senderPort = 0;
+	};
+
+	class MidiQueue;
+	class AudioEngine;
+	class ClockThread;
+	class ControlThread;
+
+	void handleAsyncUpdate() override;
+	String execute(const String& command);
+	String loadPlugin(const String& nameOrFile);
+	String getStats() const;
+	void reply(const Command& command, const String& text);
+
+	//==============================================================================
+	std::unique_ptr<MicroChromoAudioProcessor> processor;
+	std::unique_ptr<AudioEngine> engine;
+	std::unique_ptr<ClockThread> clock;
+	std::unique_ptr<ControlThread> control;
+	AudioDeviceManager deviceManager;
+
+	String deviceName;
+	double sampleRate = 48000.0;
+	int blockSize = 512, port = defaultPort;
+
+	// Filled by the control thread, emptied by the message thread.
+	static constexpr int commandCapacity = 256;
+	AbstractFifo commandFifo{ commandCapacity };
+	Command commands[commandCapacity];
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeadlessServer)
+};
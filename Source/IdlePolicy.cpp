@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    IdlePolicy.cpp
+    Created: 20 Oct 2026 1:52:17am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "IdlePolicy.h"
+
+//==============================================================================
+IdlePolicy::IdlePolicy(std::function<void()> unloadCallback)
+	: onUnload(std::move(unloadCallback))
+{
+}
+
+IdlePolicy::~IdlePolicy()
+{
+	stopTimer();
+}
+
+IdlePolicy::Tier IdlePolicy::prepare(double sampleRate)
+{
+	stopTimer();
+
+	skipAfterSamples = roundToInt(skipAfterSeconds * sampleRate);
+	idleSamples = 0;
+	return (Tier)tier.exchange(active);
+}
+
+void IdlePolicy::released()
+{
+	tier = trimmed;
+	idleSamples = 0;
+	startTimer(roundToInt(unloadAfterSeconds.load() * 1000.0));
+}
+
+void IdlePolicy::setResumeTime(Tier resumedFrom, double milliseconds) noexcept
+{
+	lastResumedTier = resumedFrom;
+	lastResumeMs = milliseconds;
+}
+
+//==============================================================================
+bool IdlePolicy::shouldSkip(bool blockIsIdle, int numSamples) noexcept
+{
+	if (!blockIsIdle)
+	{
+		idleSamples = 0;
+		tier = active;
+		return false;
+	}
+
+	idleSamples = jmin(skipAfterSamples, idleSamples + numSamples);
+	if (idleSamples < skipAfterSamples)
+		return false;
+
+	tier = skipping;
+	return true;
+}
+
+void IdlePolicy::timerCallback()
+{
+	stopTimer();
+
+	// Only if nothing prepared the processor again in the meantime.
+	if (getTier() == trimmed && onUnload != nullptr)
+		onUnload();
+}
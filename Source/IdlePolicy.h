@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    IdlePolicy.h
+    Created: 20 Oct 2026 1:52:17am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Decides how far to wind the instances down while the session is idle,
+    and keeps track of what waking them up again cost.
+
+    While the host keeps processing, the processor only skips rendering: a
+    block is idle when no MIDI reaches any instance, no note is sounding
+    and every instance is silent, and after skipAfterSeconds of idle blocks
+    the instances are not called at all until that changes. That is as far
+    as it can go there, since the host may send a note with any block.
+
+    Once the host releases the processor, nothing can arrive before the
+    next prepareToPlay(), so the processor frees its buffers and pools
+    right away. If it stays released for unloadAfterSeconds, the callback
+    runs on the message thread to save and delete the backends as well.
+    prepareToPlay() then starts from whatever is left, and the time it
+    took is reported together with the tier it resumed from.
+*/
+class IdlePolicy : private Timer
+{
+public:
+	/** From warmest to coldest. */
+	enum Tier
+	{
+		active = 0,
+		skipping,   // prepared, but the instances are not rendered
+		trimmed,    // released, buffers and pools freed
+		unloaded    // backends saved and deleted
+	};
+
+	IdlePolicy(std::function<void()> unloadCallback);
+	~IdlePolicy();
+
+	//==============================================================================
+	/** Starts over as active and returns the tier it was at. */
+	Tier prepare(double sampleRate);
+	void released();
+	void setUnloaded() noexcept { tier = unloaded; }
+
+	void setUnloadDelay(double seconds) noexcept { unloadAfterSeconds = jmax(0.0, seconds); }
+
+	/** Audio thread: returns true if the instances can be skipped for this block. */
+	bool shouldSkip(bool blockIsIdle, int numSamples) noexcept;
+
+	//==============================================================================
+	Tier getTier() const noexcept { return (Tier)tier.load(); }
+	bool isReleased() const noexcept { return getTier() >= trimmed; }
+
+	void setResumeTime(Tier resumedFrom, double milliseconds) noexcept;
+	Tier getLastResumedTier() const noexcept { return (Tier)lastResumedTier.load(); }
+	double getLastResumeMs() const noexcept { return lastResumeMs.load(); }
+
+	static constexpr double skipAfterSeconds = 1.0;
+	static constexpr double defaultUnloadSeconds = 60.0;
+
+private:
+	//==============================================================================
+	void timerCallback() override;
+
+	std::function<void()> onUnload;
+	std::atomic<int> tier{ active }, lastResumedTier{ active };
+	std::atomic<double> lastResumeMs{ 0.0 }, unloadAfterSeconds{ defaultUnloadSeconds };
+
+	int idleSamples = 0, skipAfterSamples = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IdlePolicy)
+};
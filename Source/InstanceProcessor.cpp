@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    InstanceProcessor.cpp
+    Created: 19 Oct 2026 10:41:52am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "InstanceProcessor.h"
+
+namespace
+{
+	constexpr int minDelayCapacity = 8192;
+}
+
+//==============================================================================
+InstanceProcessor::InstanceProcessor(std::unique_ptr<AudioProcessor> backendToUse, MidiEventPool& poolToUse, int index)
+	: AudioProcessor(BusesProperties().withOutput("Output", AudioChannelSet::stereo(), true)),
+	  backend(std::move(backendToUse)), pool(poolToUse), instanceIndex(index)
+{
+	jassert(backend != nullptr);
+}
+
+InstanceProcessor::~InstanceProcessor()
+{
+}
+
+//==============================================================================
+const String InstanceProcessor::getName() const
+{
+	return backend->getName() + " #" + String(instanceIndex + 1);
+}
+
+double InstanceProcessor::getTailLengthSeconds() const
+{
+	return backend->getTailLengthSeconds();
+}
+
+void InstanceProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+	// The backend was reset when it was isolated, so preparing gives it another go.
+	clearIsolation();
+
+	if (prepared.load() && sampleRate == preparedSampleRate && samplesPerBlock == preparedBlockSize)
+		return;
+
+	backend->setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+	backend->prepareToPlay(sampleRate, samplesPerBlock);
+
+	const auto numBackendChannels = jmax(2, backend->getTotalNumInputChannels(), backend->getTotalNumOutputChannels());
+	backendBuffer.setSize(numBackendChannels, samplesPerBlock, false, false, true);
+	// A MidiBuffer keeps a 6-byte header with every event's data.
+	backendMidi.ensureSize((size_t)pool.getByteCapacity() + 6 * (size_t)pool.getEventCapacity());
+
+	// Leave room for the latency to grow later on without reallocating.
+	const auto requiredCapacity = jmax(minDelayCapacity, nextPowerOfTwo(2 * backend->getLatencySamples() + samplesPerBlock));
+	if (requiredCapacity > delayCapacity)
+	{
+		delayCapacity = requiredCapacity;
+		delayBuffer.setSize(2, delayCapacity);
+	}
+
+	delayBuffer.clear();
+	delayWritePos = 0;
+
+	// The processor compensates for the latency as prepared, so only later changes count.
+	lastSeenLatency = backend->getLatencySamples();
+
+	consecutiveNonFiniteBlocks = 0;
+	silentRunSamples = 0;
+	preparedSampleRate = sampleRate;
+	preparedBlockSize = samplesPerBlock;
+	prepared = true;
+}
+
+void InstanceProcessor::releaseResources()
+{
+	prepared = false;
+	backend->releaseResources();
+
+	// Idle sessions give the memory back; preparing again allocates it anew.
+	backendBuffer.setSize(0, 0);
+	backendMidi = MidiBuffer();
+	delayBuffer.setSize(0, 0);
+	delayCapacity = 0;
+}
+
+void InstanceProcessor::reset()
+{
+	backend->reset();
+}
+
+void InstanceProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer&)
+{
+	renderBlock(buffer);
+
+	if (auto* r = recorder.load())
+		r->push(instanceIndex + 1, buffer, buffer.getNumSamples());
+}
+
+void InstanceProcessor::renderBlock(AudioBuffer<float>& buffer) noexcept
+{
+	const auto numSamples = buffer.getNumSamples();
+
+	if (isolated.load())
+	{
+		buffer.clear();
+		outputSilent = true;
+		return;
+	}
+
+	// The output is already silent and the delay line drained, so skipping
+	// the backend is inaudible until its next MIDI event.
+	if (sleepAllowed.load() && outputSilent.load() && pool.getViewSize(instanceIndex) == 0)
+	{
+		numSleptBlocks.fetch_add(1);
+		buffer.clear();
+		return;
+	}
+
+	backendMidi.clear();
+	pool.renderView(instanceIndex, backendMidi);
+
+	AudioBuffer<float> block(backendBuffer.getArrayOfWritePointers(), backendBuffer.getNumChannels(), numSamples);
+	block.clear();
+
+	{
+		// Backends may leave the FPU flags changed; the guard puts them back.
+		ScopedNoDenormals noDenormals;
+		backend->processBlock(block, backendMidi);
+	}
+
+	const auto numBackendOutputs = jmax(1, backend->getTotalNumOutputChannels());
+	auto health = BufferHealth::scan(block, numBackendOutputs, numSamples);
+
+	if (health.hasNonFinite)
+	{
+		numNonFiniteBlocks.fetch_add(1);
+		if (++consecutiveNonFiniteBlocks >= maxNonFiniteBlocks)
+		{
+			// Whatever blew up goes with the reset, so clearing starts it clean.
+			backend->reset();
+			isolated = true;
+		}
+
+		block.clear();
+		health = BufferHealth();
+	}
+	else
+	{
+		consecutiveNonFiniteBlocks = 0;
+	}
+
+	if (health.hasDenormals)
+	{
+		numDenormalBlocks.fetch_add(1);
+		for (int ch = 0; ch < jmin(numBackendOutputs, block.getNumChannels()); ++ch)
+			BufferHealth::flushDenormals(block.getWritePointer(ch), numSamples);
+	}
+
+	if (health.isSilent(silenceThreshold))
+	{
+		numSilentBlocks.fetch_add(1);
+		silentRunSamples = jmin(delayCapacity, silentRunSamples + numSamples);
+
+		if (silentRunSamples >= delayCapacity)
+		{
+			buffer.clear();
+			outputSilent = true;
+			return;
+		}
+	}
+	else
+	{
+		silentRunSamples = 0;
+	}
+
+	outputSilent = false;
+
+	const auto lastBackendChannel = numBackendOutputs - 1;
+	for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+		buffer.copyFrom(ch, 0, block, jmin(ch, lastBackendChannel), 0, numSamples);
+
+	applyCompensationDelay(buffer, numSamples);
+}
+
+void InstanceProcessor::clearIsolation() noexcept
+{
+	// The audio thread leaves the counter alone while the node is isolated.
+	if (!isolated.load())
+		return;
+
+	consecutiveNonFiniteBlocks = 0;
+	isolated = false;
+}
+
+//==============================================================================
+void InstanceProcessor::setCompensationDelay(int samples)
+{
+	// Past the preallocated capacity the instance stays misaligned rather
+	// than reallocating under the audio thread. Unprepared there is none, and
+	// the processor sets the delay again once the instances are prepared.
+	jassert(!prepared.load() || samples < delayCapacity);
+	compensationDelay = jlimit(0, jmax(0, delayCapacity - getBlockSize()), samples);
+	setLatencySamples(getBackendLatency() + compensationDelay.load());
+}
+
+bool InstanceProcessor::checkLatencyChanged() noexcept
+{
+	const auto latency = getBackendLatency();
+	if (latency == lastSeenLatency)
+		return false;
+
+	lastSeenLatency = latency;
+	return true;
+}
+
+void InstanceProcessor::applyCompensationDelay(AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+	if (delayCapacity == 0 || numSamples > delayCapacity)
+		return;
+
+	const auto delay = compensationDelay.load();
+	const auto numChannels = jmin(buffer.getNumChannels(), delayBuffer.getNumChannels());
+
+	// Always write into the ring, so a new delay reads valid history.
+	const auto writeFirst = jmin(numSamples, delayCapacity - delayWritePos);
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		delayBuffer.copyFrom(ch, delayWritePos, buffer, ch, 0, writeFirst);
+		if (writeFirst < numSamples)
+			delayBuffer.copyFrom(ch, 0, buffer, ch, writeFirst, numSamples - writeFirst);
+	}
+
+	if (delay > 0)
+	{
+		const auto readPos = (delayWritePos - delay + delayCapacity) % delayCapacity;
+		const auto readFirst = jmin(numSamples, delayCapacity - readPos);
+
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			buffer.copyFrom(ch, 0, delayBuffer, ch, readPos, readFirst);
+			if (readFirst < numSamples)
+				buffer.copyFrom(ch, readFirst, delayBuffer, ch, 0, numSamples - readFirst);
+		}
+	}
+
+	delayWritePos = (delayWritePos + numSamples) % delayCapacity;
+}
+
+//==============================================================================
+void InstanceProcessor::getStateInformation(MemoryBlock& destData)
+{
+	backend->getStateInformation(destData);
+}
+
+void InstanceProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+	backend->setStateInformation(data, sizeInBytes);
+}
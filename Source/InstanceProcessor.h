@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    InstanceProcessor.h
+    Created: 19 Oct 2026 10:41:52am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MidiEventPool.h"
+#include "BufferHealth.h"
+#include "DiskRecorder.h"
+
+//==============================================================================
+/**
+    Graph node wrapping one backend instance.
+
+    Instead of taking MIDI through a graph connection, the node reads its own
+    view out of the shared MidiEventPool, so the router can hand each instance
+    a different event stream without building a MidiBuffer per instance.
+
+    The node also delays its output so that every instance lines up with the
+    slowest one. The delay line is allocated in prepareToPlay, so changing
+    the compensation later only moves the read position.
+
+    Every block the backend renders is scanned once. NaNs and infinities
+    mute the block, and a backend that keeps producing them is reset and
+    isolated until cleared or prepared again; denormals are flushed. Once
+    the output has been silent long enough to have cleared the delay line,
+    the node hands the graph a cleared buffer, which mixing downstream
+    skips. When the processor is
+    short of time it may also let such a node sleep: as long as no MIDI
+    arrives for it, the backend is not called at all.
+
+    Preparing again with the settings the node is already prepared for does
+    nothing, so the processor can prepare its nodes itself, in parallel
+    where the backend allows, before the graph gets to them. Otherwise
+    buffers are only reallocated when they need to grow. Releasing frees
+    them.
+*/
+class InstanceProcessor : public AudioProcessor
+{
+public:
+	InstanceProcessor(std::unique_ptr<AudioProcessor> backend, MidiEventPool& pool, int instanceIndex);
+	~InstanceProcessor();
+
+	//==============================================================================
+	AudioProcessor* getBackend() const noexcept { return backend.get(); }
+	int getInstanceIndex() const noexcept { return instanceIndex; }
+
+	/** True between prepareToPlay() and releaseResources(). */
+	bool isPrepared() const noexcept { return prepared.load(); }
+
+	//==============================================================================
+	int getBackendLatency() const noexcept { return backend->getLatencySamples(); }
+	void setCompensationDelay(int samples);
+	int getCompensationDelay() const noexcept { return compensationDelay.load(); }
+	int getMaxCompensationDelay() const noexcept { return delayCapacity; }
+
+	/** Audio thread: returns true once each time the backend's latency has changed since it was prepared. */
+	bool checkLatencyChanged() noexcept;
+
+	//==============================================================================
+	int getNumNonFiniteBlocks() const noexcept { return numNonFiniteBlocks.load(); }
+	int getNumDenormalBlocks() const noexcept { return numDenormalBlocks.load(); }
+	int getNumSilentBlocks() const noexcept { return numSilentBlocks.load(); }
+	bool isOutputSilent() const noexcept { return outputSilent.load(); }
+	int getNumSleptBlocks() const noexcept { return numSleptBlocks.load(); }
+
+	void setSleepAllowed(bool shouldSleepWhenIdle) noexcept { sleepAllowed = shouldSleepWhenIdle; }
+
+	/** Instance i is recorded as the recorder's stream i + 1; pass nullptr to stop. */
+	void setRecorder(DiskRecorder* recorderToUse) noexcept { recorder = recorderToUse; }
+
+	bool isIsolated() const noexcept { return isolated.load(); }
+
+	/** Lets an isolated backend render again; it was reset when it was isolated. */
+	void clearIsolation() noexcept;
+
+	static constexpr float silenceThreshold = 1.0e-6f;
+	static constexpr int maxNonFiniteBlocks = 8;
+
+	//==============================================================================
+	const String getName() const override;
+
+	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+	void releaseResources() override;
+	void processBlock(AudioBuffer<float>&, MidiBuffer&) override;
+	void reset() override;
+
+	double getTailLengthSeconds() const override;
+	bool acceptsMidi() const override { return true; }
+	bool producesMidi() const override { return false; }
+
+	AudioProcessorEditor* createEditor() override { return nullptr; }
+	bool hasEditor() const override { return false; }
+
+	int getNumPrograms() override { return 1; }
+	int getCurrentProgram() override { return 0; }
+	void setCurrentProgram(int) override {}
+	const String getProgramName(int) override { return {}; }
+	void changeProgramName(int, const String&) override {}
+
+	void getStateInformation(MemoryBlock&) override;
+	void setStateInformation(const void*, int) override;
+
+private:
+	//==============================================================================
+	std::unique_ptr<AudioProcessor> backend;
+	MidiEventPool& pool;
+	const int instanceIndex;
+
+	AudioBuffer<float> backendBuffer;
+	MidiBuffer backendMidi;
+
+	void renderBlock(AudioBuffer<float>& buffer) noexcept;
+	void applyCompensationDelay(AudioBuffer<float>& buffer, int numSamples) noexcept;
+
+	AudioBuffer<float> delayBuffer;
+	int delayCapacity = 0, delayWritePos = 0;
+	double preparedSampleRate = 0.0;
+	int preparedBlockSize = 0;
+	std::atomic<int> compensationDelay{ 0 };
+	int lastSeenLatency = -1;
+
+	std::atomic<int> numNonFiniteBlocks{ 0 }, numDenormalBlocks{ 0 }, numSilentBlocks{ 0 }, numSleptBlocks{ 0 };
+	std::atomic<bool> isolated{ false }, outputSilent{ false }, sleepAllowed{ false }, prepared{ false };
+	int consecutiveNonFiniteBlocks = 0, silentRunSamples = 0;
+
+	std::atomic<DiskRecorder*> recorder{ nullptr };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InstanceProcessor)
+};
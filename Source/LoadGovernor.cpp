@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    LoadGovernor.cpp
+    Created: 19 Oct 2026 10:58:40pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "LoadGovernor.h"
+
+namespace
+{
+	// Time constant of the smoothed load's release.
+	constexpr double releaseSeconds = 0.2;
+}
+
+//==============================================================================
+LoadGovernor::LoadGovernor()
+{
+}
+
+LoadGovernor::~LoadGovernor()
+{
+}
+
+void LoadGovernor::prepare(double sampleRate, int samplesPerBlock)
+{
+	ignoreUnused(samplesPerBlock);
+
+	currentSampleRate = sampleRate;
+	holdSamples = roundToInt(holdSeconds * sampleRate);
+	recoverSamples = roundToInt(recoverSeconds * sampleRate);
+	releasePerSample = (float)(1.0 / (releaseSeconds * sampleRate));
+	reset();
+}
+
+void LoadGovernor::reset() noexcept
+{
+	level = normal;
+	smoothedLoad = 0.0f;
+	peakLoad = 0.0f;
+	samplesSinceChange = calmSamples = 0;
+	pendingSteals = 0;
+}
+
+//==============================================================================
+void LoadGovernor::blockStarted() noexcept
+{
+	startTicks = Time::getHighResolutionTicks();
+}
+
+void LoadGovernor::blockFinished(int numSamples) noexcept
+{
+	if (numSamples <= 0)
+		return;
+
+	const auto elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+	const auto load = (float)(elapsed * currentSampleRate / numSamples);
+
+	if (load >= 1.0f)
+		numOverruns.fetch_add(1);
+	if (load > peakLoad.load())
+		peakLoad = load;
+
+	auto smoothed = smoothedLoad.load();
+	smoothed = load > smoothed ? load : smoothed + (load - smoothed) * jmin(1.0f, releasePerSample * numSamples);
+	smoothedLoad = smoothed;
+
+	if (!enabled.load())
+	{
+		level = normal;
+		pendingSteals = 0;
+		return;
+	}
+
+	samplesSinceChange += numSamples;
+
+	if (smoothed > raiseThreshold)
+	{
+		calmSamples = 0;
+		if (samplesSinceChange < holdSamples)
+			return;
+
+		samplesSinceChange = 0;
+		if (level.load() < numLevels - 1)
+			level = level.load() + 1;
+
+		// Reaching the top level, and every step that would go past it, is a round of stealing.
+		if (level.load() == stealVoices)
+			++pendingSteals;
+	}
+	else if (smoothed < lowerThreshold && level.load() > normal)
+	{
+		calmSamples += numSamples;
+		if (calmSamples >= recoverSamples)
+		{
+			level = level.load() - 1;
+			calmSamples = 0;
+			samplesSinceChange = 0;
+		}
+	}
+	else
+	{
+		calmSamples = 0;
+	}
+}
+
+bool LoadGovernor::takeStealRequest() noexcept
+{
+	if (pendingSteals == 0)
+		return false;
+
+	--pendingSteals;
+	return true;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    LoadGovernor.h
+    Created: 19 Oct 2026 10:58:40pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Watches how much of each block's time budget rendering takes, and decides
+    how much quality to give up to stay within it.
+
+    The load is the render time over the block's duration. It is smoothed
+    with an instant attack and a slow release, so a single heavy block counts
+    straight away but recovery needs a calm stretch. Above the raise
+    threshold the level goes up one step at a time, a short hold apart so
+    each step gets a chance to show its effect. It comes back down one step
+    after the load has stayed below the lower threshold for recoverSeconds.
+    The gap between the two thresholds keeps it from flapping.
+
+    Once at the top level, further overload asks for another round of voice
+    stealing instead, no more often than the hold allows.
+*/
+class LoadGovernor
+{
+public:
+	/** In the order they are applied; each level includes the ones before. */
+	enum Level
+	{
+		normal = 0,
+		coarseGlides,       // bends from glides are sent less often
+		sleepIdleInstances, // silent instances without MIDI skip their backend
+		stealVoices,        // the quietest notes are released to meet a voice limit
+		numLevels
+	};
+
+	LoadGovernor();
+	~LoadGovernor();
+
+	void prepare(double sampleRate, int samplesPerBlock);
+	void reset() noexcept;
+
+	void setEnabled(bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+	bool isEnabled() const noexcept { return enabled.load(); }
+
+	//==============================================================================
+	/** Audio thread, around the work that is measured. */
+	void blockStarted() noexcept;
+	void blockFinished(int numSamples) noexcept;
+
+	Level getLevel() const noexcept { return (Level)level.load(); }
+
+	/** Audio thread: true once for each round of stealing asked for since the last call. */
+	bool takeStealRequest() noexcept;
+
+	//==============================================================================
+	float getLoad() const noexcept { return smoothedLoad.load(); }
+	float getPeakLoad() const noexcept { return peakLoad.load(); }
+	int getNumOverruns() const noexcept { return numOverruns.load(); }
+
+	static constexpr float raiseThreshold = 0.8f;
+	static constexpr float lowerThreshold = 0.5f;
+	static constexpr double holdSeconds = 0.02;
+	static constexpr double recoverSeconds = 0.5;
+
+private:
+	//==============================================================================
+	std::atomic<bool> enabled{ true };
+	std::atomic<int> level{ normal };
+	std::atomic<float> smoothedLoad{ 0.0f }, peakLoad{ 0.0f };
+	std::atomic<int> numOverruns{ 0 };
+
+	double currentSampleRate = 44100.0;
+	int64 startTicks = 0;
+	int samplesSinceChange = 0, calmSamples = 0;
+	int holdSamples = 0, recoverSamples = 0;
+	float releasePerSample = 0.0f;
+	int pendingSteals = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadGovernor)
+};
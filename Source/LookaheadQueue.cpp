@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    LookaheadQueue.cpp
+    Created: 19 Oct 2026 6:12:08pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "LookaheadQueue.h"
+
+namespace
+{
+	// The queue holds everything that arrived within the delay plus one
+	// block, at the same density MidiEventPool is sized for.
+	constexpr int minEventCapacity = 1024;
+	constexpr int bytesPerEvent = 4;
+	constexpr int minSysexBytes = 4096;
+}
+
+//==============================================================================
+LookaheadQueue::LookaheadQueue()
+{
+}
+
+LookaheadQueue::~LookaheadQueue()
+{
+}
+
+void LookaheadQueue::prepare(int delaySamples, int samplesPerBlock)
+{
+	eventCapacity = jmax(minEventCapacity, delaySamples + samplesPerBlock);
+	byteCapacity = eventCapacity * bytesPerEvent + minSysexBytes;
+
+	entries.allocate((size_t)eventCapacity, false);
+	bytes.allocate((size_t)byteCapacity, false);
+
+	numDroppedEvents = 0;
+	clear();
+}
+
+void LookaheadQueue::clear() noexcept
+{
+	head = 0;
+	numEntries = 0;
+	writePos = 0;
+}
+
+//==============================================================================
+bool LookaheadQueue::push(int64 dueSample, const uint8* data, int numBytes, int tag) noexcept
+{
+	if (numEntries >= eventCapacity || numBytes <= 0 || numBytes > byteCapacity)
+	{
+		numDroppedEvents.fetch_add(1);
+		return false;
+	}
+
+	// Bytes are written contiguously. While the writer is ahead of the oldest
+	// event it may use the rest of the ring or wrap to the start; once it has
+	// wrapped it may only fill up to the oldest event.
+	if (numEntries == 0)
+	{
+		writePos = 0;
+	}
+	else
+	{
+		const auto readPos = entries[head].dataOffset;
+
+		if (writePos > readPos)
+		{
+			if (writePos + numBytes > byteCapacity)
+			{
+				if (numBytes > readPos)
+				{
+					numDroppedEvents.fetch_add(1);
+					return false;
+				}
+				writePos = 0;
+			}
+		}
+		else if (writePos + numBytes > readPos)
+		{
+			numDroppedEvents.fetch_add(1);
+			return false;
+		}
+	}
+
+	auto& e = entries[(head + numEntries) % eventCapacity];
+	e.dueSample = dueSample;
+	e.dataOffset = writePos;
+	e.numBytes = numBytes;
+	e.tag = tag;
+
+	memcpy(bytes + writePos, data, (size_t)numBytes);
+	writePos += numBytes;
+	++numEntries;
+	return true;
+}
+
+void LookaheadQueue::pop() noexcept
+{
+	if (numEntries == 0)
+		return;
+
+	head = (head + 1) % eventCapacity;
+	--numEntries;
+}
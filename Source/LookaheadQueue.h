@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    LookaheadQueue.h
+    Created: 19 Oct 2026 6:12:08pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A first-in first-out ring of MIDI events waiting to be played.
+
+    Events go in with the absolute sample they are due at, which only grows,
+    so the ring stays sorted without any searching. Event records and their
+    bytes live in two rings allocated in prepare(); an event that does not
+    fit is dropped and counted rather than allocating on the audio thread.
+*/
+class LookaheadQueue
+{
+public:
+	struct Entry
+	{
+		int64 dueSample;
+		int dataOffset;
+		int numBytes;
+		int tag;
+	};
+
+	//==============================================================================
+	LookaheadQueue();
+	~LookaheadQueue();
+
+	void prepare(int delaySamples, int samplesPerBlock);
+	void clear() noexcept;
+
+	//==============================================================================
+	bool push(int64 dueSample, const uint8* data, int numBytes, int tag) noexcept;
+
+	bool isEmpty() const noexcept { return numEntries == 0; }
+	const Entry& front() const noexcept { return entries[head]; }
+	const uint8* frontData() const noexcept { return bytes + entries[head].dataOffset; }
+	void pop() noexcept;
+
+	int getEventCapacity() const noexcept { return eventCapacity; }
+	int getNumDroppedEvents() const noexcept { return numDroppedEvents.load(); }
+
+private:
+	//==============================================================================
+	HeapBlock<Entry> entries;
+	HeapBlock<uint8> bytes;
+
+	int eventCapacity = 0, byteCapacity = 0;
+	int head = 0, numEntries = 0, writePos = 0;
+	std::atomic<int> numDroppedEvents{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LookaheadQueue)
+};
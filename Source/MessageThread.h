@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    MessageThread.h
+    Created: 20 Oct 2026 3:12:08am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Runs fn on the message thread and waits for it, for the command-line
+    modes that drive the processor from threads of their own.
+*/
+template <typename Function>
+void runOnMessageThread(Function&& fn)
+{
+	if (MessageManager::getInstance()->isThisTheMessageThread())
+	{
+		fn();
+		return;
+	}
+
+	WaitableEvent done;
+	MessageManager::callAsync([&] { fn(); done.signal(); });
+	done.wait();
+}
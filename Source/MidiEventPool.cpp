@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    MidiEventPool.cpp
+    Created: 19 Oct 2026 10:03:17am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "MidiEventPool.h"
+
+namespace
+{
+	// Sized for dense passages: 10k events/s is about one event every five
+	// samples at 48kHz, so one slot per sample leaves plenty of headroom for
+	// inserted pitch bends on top of the incoming stream.
+	constexpr int minEventCapacity = 1024;
+	constexpr int eventsPerSample = 1;
+	constexpr int bytesPerEvent = 4;
+	constexpr int minSysexBytes = 4096;
+}
+
+//==============================================================================
+MidiEventPool::MidiEventPool()
+{
+}
+
+MidiEventPool::~MidiEventPool()
+{
+}
+
+void MidiEventPool::prepare(int numInstances, int samplesPerBlock)
+{
+	eventCapacity = jmax(minEventCapacity, samplesPerBlock * eventsPerSample);
+	byteCapacity = eventCapacity * bytesPerEvent + minSysexBytes;
+
+	events.allocate((size_t)eventCapacity, false);
+	bytes.allocate((size_t)byteCapacity, false);
+
+	views.clear();
+	for (int i = 0; i < numInstances; ++i)
+	{
+		auto* view = views.add(new View());
+		view->indices.allocate((size_t)eventCapacity, false);
+	}
+
+	numDroppedEvents = 0;
+	clear();
+}
+
+void MidiEventPool::release()
+{
+	events.free();
+	bytes.free();
+	views.clear();
+
+	eventCapacity = byteCapacity = 0;
+	clear();
+}
+
+void MidiEventPool::clear() noexcept
+{
+	numEvents = 0;
+	numBytesUsed = 0;
+
+	for (auto* view : views)
+		view->size = 0;
+}
+
+//==============================================================================
+int MidiEventPool::addEvent(const uint8* data, int numBytes, int samplePosition) noexcept
+{
+	if (numEvents >= eventCapacity || numBytesUsed + numBytes > byteCapacity)
+	{
+		numDroppedEvents.fetch_add(1);
+		return -1;
+	}
+
+	auto& e = events[numEvents];
+	e.samplePosition = samplePosition;
+	e.dataOffset = numBytesUsed;
+	e.numBytes = numBytes;
+
+	memcpy(bytes + numBytesUsed, data, (size_t)numBytes);
+	numBytesUsed += numBytes;
+
+	return numEvents++;
+}
+
+int MidiEventPool::addShortEvent(uint8 status, uint8 data1, uint8 data2, int samplePosition) noexcept
+{
+	const uint8 data[] = { status, data1, data2 };
+	return addEvent(data, 3, samplePosition);
+}
+
+void MidiEventPool::addToView(int instance, int eventIndex) noexcept
+{
+	if (eventIndex < 0 || !isPositiveAndBelow(instance, views.size()))
+		return;
+
+	auto* view = views.getUnchecked(instance);
+	if (view->size < eventCapacity)
+		view->indices[view->size++] = eventIndex;
+}
+
+void MidiEventPool::addToAllViews(int eventIndex) noexcept
+{
+	for (int i = 0; i < views.size(); ++i)
+		addToView(i, eventIndex);
+}
+
+void MidiEventPool::setChannel(int eventIndex, int channel) noexcept
+{
+	if (!isPositiveAndBelow(eventIndex, numEvents))
+		return;
+
+	auto* status = bytes + events[eventIndex].dataOffset;
+
+	// Only channel voice messages carry a channel nibble.
+	if (*status >= 0x80 && *status < 0xf0)
+		*status = (uint8)((*status & 0xf0) | (channel & 0x0f));
+}
+
+//==============================================================================
+void MidiEventPool::renderView(int instance, MidiBuffer& dest) const noexcept
+{
+	if (!isPositiveAndBelow(instance, views.size()))
+		return;
+
+	auto* view = views.getUnchecked(instance);
+	for (int i = 0; i < view->size; ++i)
+	{
+		const auto& e = events[view->indices[i]];
+		dest.addEvent(bytes + e.dataOffset, e.numBytes, e.samplePosition);
+	}
+}
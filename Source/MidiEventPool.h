@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    MidiEventPool.h
+    Created: 19 Oct 2026 10:03:17am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A per-block store of MIDI events shared by all backend instances.
+
+    Each event is written once into a flat array; every instance owns a view,
+    which is just a list of indices into that array. Broadcasting a controller
+    to N instances therefore costs N integers rather than N copies, and channel
+    remapping rewrites the status byte in place.
+
+    Capacity is reserved in prepare() from the block size, so nothing here
+    allocates on the audio thread. Events that do not fit are dropped and
+    counted.
+*/
+class MidiEventPool
+{
+public:
+	struct Event
+	{
+		int samplePosition;
+		int dataOffset;
+		int numBytes;
+	};
+
+	//==============================================================================
+	MidiEventPool();
+	~MidiEventPool();
+
+	void prepare(int numInstances, int samplesPerBlock);
+
+	/** Frees the storage until the next prepare(); events added meanwhile are dropped. */
+	void release();
+	void clear() noexcept;
+
+	//==============================================================================
+	int addEvent(const uint8* data, int numBytes, int samplePosition) noexcept;
+	int addShortEvent(uint8 status, uint8 data1, uint8 data2, int samplePosition) noexcept;
+
+	void addToView(int instance, int eventIndex) noexcept;
+	void addToAllViews(int eventIndex) noexcept;
+
+	void setChannel(int eventIndex, int channel) noexcept;
+
+	//==============================================================================
+	int getNumEvents() const noexcept { return numEvents; }
+	int getNumViews() const noexcept { return views.size(); }
+	const Event& getEvent(int eventIndex) const noexcept { return events[eventIndex]; }
+	const uint8* getEventData(int eventIndex) const noexcept { return bytes + events[eventIndex].dataOffset; }
+
+	void renderView(int instance, MidiBuffer& dest) const noexcept;
+	int getViewSize(int instance) const noexcept { auto* view = views[instance]; return view != nullptr ? view->size : 0; }
+
+	int getEventCapacity() const noexcept { return eventCapacity; }
+	int getByteCapacity() const noexcept { return byteCapacity; }
+	int getNumDroppedEvents() const noexcept { return numDroppedEvents.load(); }
+
+private:
+	//==============================================================================
+	struct View
+	{
+		HeapBlock<int> indices;
+		int size = 0;
+	};
+
+	HeapBlock<Event> events;
+	HeapBlock<uint8> bytes;
+	OwnedArray<View> views;
+
+	int eventCapacity = 0, byteCapacity = 0;
+	int numEvents = 0, numBytesUsed = 0;
+	std::atomic<int> numDroppedEvents{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiEventPool)
+};
@@ -0,0 +1,925 @@
+/*
+  ==============================================================================
+
+    MidiRouter.cpp
+    Created: 19 Oct 2026 11:20:05am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "MidiRouter.h"
+
+//==============================================================================
+MidiRouter::MidiRouter(MidiEventPool& poolToUse)
+	: pool(poolToUse)
+{
+	std::fill(std::begin(noteOffsets), std::end(noteOffsets), 0.0f);
+	std::fill(std::begin(staticOffsets), std::end(staticOffsets), 0.0f);
+	pendingNoteOffsets.insertMultiple(0, 0.0f, 128);
+	reset();
+}
+
+MidiRouter::~MidiRouter()
+{
+}
+
+void MidiRouter::prepare(int numInstances, double sampleRate, int samplesPerBlock)
+{
+	preparedMode = outputMode;
+	preparedLowerZone = mpeLowerZone;
+	preparedPitchbendRange = mpePitchbendRange;
+	preparedLookahead = lookaheadSamples;
+	lookahead.prepare(preparedLookahead, samplesPerBlock);
+	currentSampleRate = sampleRate;
+	glides.prepare(sampleRate, samplesPerBlock);
+	appliedCoarseGlides = false;
+	blockStartSample = 0;
+
+	instances.clearQuick();
+	instances.insertMultiple(0, InstanceState(), preparedMode == OutputMode::mpe ? 1 : jmax(1, numInstances));
+
+	// The zone layout is only sent to the freshly created backend once, on the
+	// first block after preparing, rather than being repeated every block.
+	memberChannelMask = 0;
+	if (preparedMode == OutputMode::mpe)
+	{
+		masterChannel = preparedLowerZone ? 0 : 15;
+		for (int i = 1; i <= mpeNumMemberChannels; ++i)
+			memberChannelMask |= (uint16)(1 << (preparedLowerZone ? i : 15 - i));
+
+		zoneConfiguration = preparedLowerZone ? MPEMessages::setLowerZone(mpeNumMemberChannels, preparedPitchbendRange)
+		                                      : MPEMessages::setUpperZone(mpeNumMemberChannels, preparedPitchbendRange);
+		zoneConfigurationPending = true;
+	}
+	else
+	{
+		zoneConfiguration.clear();
+		zoneConfigurationPending = false;
+	}
+
+	reset();
+}
+
+void MidiRouter::reset() noexcept
+{
+	for (auto& row : noteInstance)
+		std::fill(std::begin(row), std::end(row), (int8)-1);
+
+	soundingNotes.clear();
+	numSoundingNotes = 0;
+
+	for (auto& inst : instances)
+		inst = InstanceState();
+
+	for (auto& row : noteChannel)
+		std::fill(std::begin(row), std::end(row), (int8)-1);
+
+	for (auto& member : memberChannels)
+		member = MemberChannelState();
+	occupiedChannels = 0;
+	reservedChannels = 0;
+
+	lookahead.clear();
+	userBendSemitones = 0.0f;
+	noteCounter = 0;
+
+	glides.reset();
+	lastPlayedNote = -1;
+
+	adaptiveTuning.reset();
+	refreshNoteOffsets();
+}
+
+//==============================================================================
+void MidiRouter::setNoteOffsets(const Array<float>& centsPerNote)
+{
+	{
+		const SpinLock::ScopedLockType sl(noteOffsetLock);
+		for (int i = 0; i < 128; ++i)
+			pendingNoteOffsets.set(i, centsPerNote[i]);
+	}
+	noteOffsetsChanged = true;
+}
+
+void MidiRouter::setPitchBendRange(float semitones)
+{
+	pitchBendRange = jmax(0.01f, semitones);
+}
+
+void MidiRouter::setBendTuningEnabled(bool shouldInsertBends)
+{
+	bendTuningEnabled = shouldInsertBends;
+}
+
+void MidiRouter::setOutputMode(OutputMode newMode)
+{
+	outputMode = newMode;
+}
+
+void MidiRouter::setMpeZone(bool useLowerZone, int numMemberChannels, int perNotePitchbendRange)
+{
+	mpeLowerZone = useLowerZone;
+	mpeNumMemberChannels = jlimit(1, 15, numMemberChannels);
+	mpePitchbendRange = jlimit(1, 96, perNotePitchbendRange);
+}
+
+void MidiRouter::setGlide(float retuneMs, float newPortamentoMs, GlideEngine::Shape shape)
+{
+	retuneGlideMs = jmax(0.0f, retuneMs);
+	portamentoMs = jmax(0.0f, newPortamentoMs);
+	glideShape = (int)shape;
+}
+
+void MidiRouter::setLookahead(int samples)
+{
+	lookaheadSamples = jmax(0, samples);
+}
+
+void MidiRouter::setCustomGlideShape(float a, float b)
+{
+	customGlideA = a;
+	customGlideB = b;
+}
+
+void MidiRouter::setNextRetuneGlide(float ms)
+{
+	nextRetuneGlideMs = jmax(0.0f, ms);
+}
+
+void MidiRouter::setAdaptiveTuning(bool shouldAdapt, float driftLimitCents)
+{
+	adaptiveDriftCents = jmax(0.0f, driftLimitCents);
+	adaptiveTuningEnabled = shouldAdapt;
+}
+
+bool MidiRouter::pullPendingNoteOffsets() noexcept
+{
+	if (!noteOffsetsChanged.load())
+		return false;
+
+	const SpinLock::ScopedTryLockType sl(noteOffsetLock);
+	if (!sl.isLocked())
+		return false;
+
+	for (int i = 0; i < 128; ++i)
+		staticOffsets[i] = pendingNoteOffsets.getUnchecked(i);
+	noteOffsetsChanged = false;
+	return !adaptiveTuningActive;
+}
+
+bool MidiRouter::pullAdaptiveTuningSettings() noexcept
+{
+	adaptiveTuning.setDriftLimit(adaptiveDriftCents.load());
+
+	const auto enabled = adaptiveTuningEnabled.load();
+	if (enabled == adaptiveTuningActive)
+		return false;
+
+	// Switching on mid-phrase starts from the notes already held.
+	adaptiveTuningActive = enabled;
+	adaptiveTuning.reset();
+
+	if (enabled)
+		for (int ch = 0; ch < 16; ++ch)
+			for (int note = 0; note < 128; ++note)
+				if (isSounding(ch, note))
+					adaptiveTuning.noteOn(note);
+
+	return true;
+}
+
+void MidiRouter::refreshNoteOffsets() noexcept
+{
+	for (int i = 0; i < 128; ++i)
+		noteOffsets[i] = adaptiveTuningActive ? adaptiveTuning.getOffset(i) : staticOffsets[i];
+}
+
+int MidiRouter::getGlideSamples(float ms) const noexcept
+{
+	return roundToInt(ms * 0.001 * currentSampleRate);
+}
+
+//==============================================================================
+void MidiRouter::process(const MidiBuffer& input, int numSamples) noexcept
+{
+	auto tuningChanged = pullPendingNoteOffsets();
+	tuningChanged = pullAdaptiveTuningSettings() || tuningChanged;
+	pool.clear();
+	glides.setCustomShape(customGlideA.load(), customGlideB.load());
+
+	if (zoneConfigurationPending)
+		sendZoneConfiguration();
+
+	if (tuningChanged)
+	{
+		refreshNoteOffsets();
+		retuneSoundingNotes(0);
+	}
+
+	updateGlideResolution();
+	while (voiceLimit > 0 && numSoundingNotes > voiceLimit)
+		releaseQuietestNote(0);
+
+	if (preparedLookahead > 0)
+	{
+		processWithLookahead(input, numSamples);
+	}
+	else
+	{
+		MidiBuffer::Iterator it(input);
+		const uint8* data;
+		int numBytes, samplePosition;
+
+		while (it.getNextEvent(data, numBytes, samplePosition))
+			if (numBytes > 0)
+				routeEvent(data, numBytes, samplePosition, -1);
+	}
+
+	renderGlides(numSamples);
+	blockStartSample += numSamples;
+}
+
+void MidiRouter::routeEvent(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept
+{
+	const auto status = data[0] & 0xf0;
+	if (!adaptiveTuningActive || numBytes < 3 || (status != 0x80 && status != 0x90))
+	{
+		dispatchEvent(data, numBytes, samplePosition, reservation);
+		return;
+	}
+
+	// Retriggers and stray note-offs leave the pitch classes alone.
+	const auto channel = data[0] & 0x0f;
+	const auto note = data[1] & 0x7f;
+	const auto isNoteOn = status == 0x90 && data[2] > 0;
+	const auto wasSounding = isSounding(channel, note);
+
+	// A new note retunes the held ones first, so they move together.
+	if (isNoteOn && !wasSounding && adaptiveTuning.noteOn(note))
+	{
+		refreshNoteOffsets();
+		retuneSoundingNotes(samplePosition);
+	}
+
+	dispatchEvent(data, numBytes, samplePosition, reservation);
+
+	if (!isNoteOn && wasSounding && adaptiveTuning.noteOff(note))
+	{
+		refreshNoteOffsets();
+		retuneSoundingNotes(samplePosition);
+	}
+}
+
+bool MidiRouter::isSounding(int channel, int note) const noexcept
+{
+	return preparedMode == OutputMode::mpe ? noteChannel[channel][note] >= 0 : noteInstance[channel][note] >= 0;
+}
+
+void MidiRouter::dispatchEvent(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept
+{
+	if (preparedMode == OutputMode::mpe)
+	{
+		handleMpeEvent(data, numBytes, samplePosition, reservation);
+		return;
+	}
+
+	const auto status = data[0] & 0xf0;
+
+	if (status == 0x90 && numBytes >= 3 && data[2] > 0)
+	{
+		if (voiceLimit > 0 && numSoundingNotes >= voiceLimit && noteInstance[data[0] & 0x0f][data[1] & 0x7f] < 0)
+			releaseQuietestNote(samplePosition);
+
+		handleNoteOn(data, numBytes, samplePosition, reservation);
+	}
+	else if ((status == 0x80 || status == 0x90) && numBytes >= 3)
+	{
+		handleNoteOff(data, numBytes, samplePosition);
+	}
+	else if (status == 0xa0 && numBytes >= 3)
+	{
+		// Polyphonic aftertouch follows its note.
+		const auto inst = noteInstance[data[0] & 0x0f][data[1] & 0x7f];
+		const auto index = pool.addEvent(data, numBytes, samplePosition);
+		pool.setChannel(index, outputChannel);
+
+		if (inst >= 0)
+			pool.addToView(inst, index);
+	}
+	else if (status == 0xe0 && numBytes >= 3 && bendTuningEnabled.load())
+	{
+		handlePitchWheel(data, samplePosition);
+	}
+	else
+	{
+		const auto index = pool.addEvent(data, numBytes, samplePosition);
+		pool.setChannel(index, outputChannel);
+		pool.addToAllViews(index);
+	}
+}
+
+void MidiRouter::updateGlideResolution() noexcept
+{
+	if (coarseGlides == appliedCoarseGlides)
+		return;
+
+	// Coarser steps and longer intervals cut the bends sent per glide by
+	// about four, at the cost of audible stepping on slow glides.
+	glides.setToleranceCents(coarseGlides ? 4.0f : 1.0f);
+	glides.setIntervalLimits(coarseGlides ? 8.0f : 2.0f, coarseGlides ? 100.0f : 50.0f);
+	appliedCoarseGlides = coarseGlides;
+}
+
+void MidiRouter::releaseQuietestNote(int samplePosition) noexcept
+{
+	int quietestChannel, quietestNote;
+	if (!soundingNotes.findQuietest(quietestChannel, quietestNote))
+	{
+		numSoundingNotes = 0;
+		return;
+	}
+
+	const uint8 noteOff[] = { (uint8)(0x80 | quietestChannel), (uint8)quietestNote, 0 };
+	routeEvent(noteOff, 3, samplePosition, -1);
+}
+
+void MidiRouter::processWithLookahead(const MidiBuffer& input, int numSamples) noexcept
+{
+	// Arrivals and due events are merged in output order: an event arriving
+	// at sample p is due at p + lookahead, but is looked at now, so that its
+	// voice can be prepared in the meantime.
+	MidiBuffer::Iterator it(input);
+	const uint8* data;
+	int numBytes, samplePosition;
+
+	auto hasInput = it.getNextEvent(data, numBytes, samplePosition);
+	const auto blockEnd = blockStartSample + numSamples;
+
+	for (;;)
+	{
+		const auto hasDue = !lookahead.isEmpty() && lookahead.front().dueSample < blockEnd;
+		if (!hasDue && !hasInput)
+			break;
+
+		const auto duePosition = hasDue ? jmax(0, (int)(lookahead.front().dueSample - blockStartSample)) : numSamples;
+
+		if (hasDue && (!hasInput || duePosition <= samplePosition))
+		{
+			const auto& e = lookahead.front();
+			routeEvent(lookahead.frontData(), e.numBytes, duePosition, e.tag);
+			lookahead.pop();
+		}
+		else
+		{
+			if (numBytes > 0)
+			{
+				// A full queue drops the event, and the note will never claim its voice.
+				const auto reservation = reserveForNote(data, numBytes, samplePosition);
+				if (!lookahead.push(blockStartSample + samplePosition + preparedLookahead, data, numBytes, reservation))
+					cancelReservation(reservation);
+			}
+			hasInput = it.getNextEvent(data, numBytes, samplePosition);
+		}
+	}
+}
+
+int MidiRouter::reserveForNote(const uint8* data, int numBytes, int samplePosition) noexcept
+{
+	if ((data[0] & 0xf0) != 0x90 || numBytes < 3 || data[2] == 0)
+		return -1;
+
+	const auto note = data[1] & 0x7f;
+	const auto offset = noteOffsets[note];
+
+	if (preparedMode == OutputMode::mpe)
+	{
+		// With portamento the starting bend depends on the note played before,
+		// which is only known when the note is due.
+		if (getGlideSamples(portamentoMs.load()) > 0)
+			return -1;
+
+		const uint32 freeChannels = memberChannelMask & ~occupiedChannels & ~reservedChannels;
+		if (freeChannels == 0)
+			return -1;
+
+		const auto ch = preparedLowerZone ? findHighestSetBit(freeChannels & (~freeChannels + 1u))
+		                                  : findHighestSetBit(freeChannels);
+
+		reservedChannels |= (uint16)(1 << ch);
+		glides.stopGlide(ch);
+		memberChannels[ch].currentCents = offset;
+		sendMemberBend(ch, toMpeBend(offset), samplePosition);
+		return ch;
+	}
+
+	if (!bendTuningEnabled.load())
+		return -1;
+
+	// Only an instance that stays silent until the note is due may be bent
+	// early; otherwise the note falls back to allocation when it is played.
+	int best = -1;
+	for (int i = 0; i < instances.size(); ++i)
+	{
+		const auto& inst = instances.getReference(i);
+		if (inst.numNotes > 0 || inst.numReserved > 0)
+		{
+			if (std::abs(inst.offsetCents - offset) < 0.5f)
+			{
+				best = i;
+				break;
+			}
+			continue;
+		}
+
+		if (best < 0 || inst.lastUsed < instances.getReference(best).lastUsed)
+			best = i;
+	}
+
+	if (best < 0)
+		return -1;
+
+	auto& inst = instances.getReference(best);
+	inst.numReserved++;
+	inst.lastUsed = ++noteCounter;
+
+	if (inst.numNotes == 0)
+	{
+		glides.stopGlide(best);
+		inst.offsetCents = offset;
+		inst.currentCents = offset;
+		sendBend(best, toBend(offset), samplePosition);
+	}
+
+	return best;
+}
+
+void MidiRouter::cancelReservation(int reservation) noexcept
+{
+	if (reservation < 0)
+		return;
+
+	if (preparedMode == OutputMode::mpe)
+	{
+		reservedChannels &= (uint16)~(1 << reservation);
+	}
+	else if (reservation < instances.size())
+	{
+		auto& inst = instances.getReference(reservation);
+		inst.numReserved = jmax(0, inst.numReserved - 1);
+	}
+}
+
+void MidiRouter::retuneSoundingNotes(int samplePosition) noexcept
+{
+	const auto overrideMs = nextRetuneGlideMs.exchange(-1.0f);
+	const auto duration = getGlideSamples(overrideMs >= 0.0f ? overrideMs : retuneGlideMs.load());
+	const auto shape = (GlideEngine::Shape)glideShape.load();
+
+	if (preparedMode == OutputMode::mpe)
+	{
+		for (int ch = 0; ch < 16; ++ch)
+		{
+			auto& member = memberChannels[ch];
+			if ((occupiedChannels & (1 << ch)) == 0 || member.lastNote < 0)
+				continue;
+
+			const auto target = noteOffsets[member.lastNote];
+			if (duration > 0)
+			{
+				glides.startGlide(ch, member.currentCents, target, blockStartSample + samplePosition, duration, shape);
+			}
+			else
+			{
+				member.currentCents = target;
+				sendMemberBend(ch, toMpeBend(target), samplePosition);
+			}
+		}
+	}
+	else if (bendTuningEnabled.load())
+	{
+		for (int i = 0; i < instances.size(); ++i)
+		{
+			auto& inst = instances.getReference(i);
+			if (inst.numNotes == 0 || inst.lastNote < 0)
+				continue;
+
+			const auto target = noteOffsets[inst.lastNote];
+			inst.offsetCents = target;
+
+			if (duration > 0)
+			{
+				glides.startGlide(i, inst.currentCents, target, blockStartSample + samplePosition, duration, shape);
+			}
+			else
+			{
+				inst.currentCents = target;
+				sendBend(i, toBend(target), samplePosition);
+			}
+		}
+	}
+}
+
+void MidiRouter::renderGlides(int numSamples) noexcept
+{
+	glides.render(blockStartSample, numSamples, [this](int voice, int samplePosition, float cents)
+	{
+		if (preparedMode == OutputMode::mpe)
+		{
+			if (voice < 16)
+			{
+				memberChannels[voice].currentCents = cents;
+				sendMemberBend(voice, toMpeBend(cents), samplePosition);
+			}
+		}
+		else if (voice < instances.size())
+		{
+			instances.getReference(voice).currentCents = cents;
+			sendBend(voice, toBend(cents), samplePosition);
+		}
+	});
+}
+
+//==============================================================================
+int MidiRouter::toBend(float offsetCents) const noexcept
+{
+	const auto semitones = userBendSemitones + offsetCents * 0.01f;
+	return jlimit(0, 16383, 8192 + roundToInt(semitones / pitchBendRange.load() * 8192.0f));
+}
+
+int MidiRouter::allocateInstance(float offsetCents) noexcept
+{
+	const auto numInstances = instances.size();
+
+	if (!bendTuningEnabled.load())
+	{
+		int best = 0;
+		for (int i = 1; i < numInstances; ++i)
+			if (instances.getReference(i).numNotes < instances.getReference(best).numNotes)
+				best = i;
+		return best;
+	}
+
+	// An instance already bent to this offset can share the note.
+	int idle = -1, oldest = 0;
+	for (int i = 0; i < numInstances; ++i)
+	{
+		const auto& inst = instances.getReference(i);
+		const auto matches = std::abs(inst.offsetCents - offsetCents) < 0.5f;
+
+		if (matches && (inst.numNotes > 0 || inst.numReserved > 0))
+			return i;
+
+		if (inst.numNotes == 0 && inst.numReserved == 0)
+		{
+			if (matches)
+				return i;
+			if (idle < 0 || inst.lastUsed < instances.getReference(idle).lastUsed)
+				idle = i;
+		}
+
+		if (inst.lastUsed < instances.getReference(oldest).lastUsed)
+			oldest = i;
+	}
+
+	return idle >= 0 ? idle : oldest;
+}
+
+void MidiRouter::sendBend(int instance, int bend, int samplePosition) noexcept
+{
+	auto& inst = instances.getReference(instance);
+	if (inst.bend == bend)
+		return;
+
+	inst.bend = bend;
+	const auto index = pool.addShortEvent((uint8)(0xe0 | outputChannel), (uint8)(bend & 0x7f), (uint8)((bend >> 7) & 0x7f), samplePosition);
+	pool.addToView(instance, index);
+}
+
+void MidiRouter::handleNoteOn(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept
+{
+	const auto channel = data[0] & 0x0f;
+	const auto note = data[1] & 0x7f;
+	const auto offset = noteOffsets[note];
+
+	if (isPositiveAndBelow(reservation, instances.size()))
+	{
+		auto& reserved = instances.getReference(reservation);
+		reserved.numReserved = jmax(0, reserved.numReserved - 1);
+	}
+	else
+	{
+		reservation = -1;
+	}
+
+	auto inst = (int)noteInstance[channel][note];
+	if (inst < 0)
+	{
+		inst = reservation >= 0 ? reservation : allocateInstance(offset);
+		instances.getReference(inst).numNotes++;
+		noteInstance[channel][note] = (int8)inst;
+		numSoundingNotes++;
+	}
+
+	soundingNotes.add(channel, note, data[2]);
+
+	auto& state = instances.getReference(inst);
+	state.lastUsed = ++noteCounter;
+
+	if (bendTuningEnabled.load())
+	{
+		glides.stopGlide(inst);
+		state.offsetCents = offset;
+		state.currentCents = offset;
+		state.lastNote = note;
+		sendBend(inst, toBend(offset), samplePosition);
+	}
+
+	const auto index = pool.addEvent(data, numBytes, samplePosition);
+	pool.setChannel(index, outputChannel);
+	pool.addToView(inst, index);
+}
+
+void MidiRouter::handleNoteOff(const uint8* data, int numBytes, int samplePosition) noexcept
+{
+	const auto channel = data[0] & 0x0f;
+	const auto note = data[1] & 0x7f;
+	const auto inst = (int)noteInstance[channel][note];
+
+	const auto index = pool.addEvent(data, numBytes, samplePosition);
+	pool.setChannel(index, outputChannel);
+
+	if (inst < 0)
+	{
+		// Unknown note, e.g. held across a reset: let every instance see it.
+		pool.addToAllViews(index);
+		return;
+	}
+
+	noteInstance[channel][note] = -1;
+	soundingNotes.remove(channel, note);
+	numSoundingNotes = jmax(0, numSoundingNotes - 1);
+	auto& state = instances.getReference(inst);
+	state.numNotes = jmax(0, state.numNotes - 1);
+	pool.addToView(inst, index);
+}
+
+void MidiRouter::handlePitchWheel(const uint8* data, int samplePosition) noexcept
+{
+	const auto value = (data[1] & 0x7f) | ((data[2] & 0x7f) << 7);
+	userBendSemitones = (value - 8192) / 8192.0f * pitchBendRange.load();
+
+	for (int i = 0; i < instances.size(); ++i)
+		sendBend(i, toBend(instances.getReference(i).currentCents), samplePosition);
+}
+
+//==============================================================================
+void MidiRouter::sendZoneConfiguration() noexcept
+{
+	MidiBuffer::Iterator it(zoneConfiguration);
+	const uint8* data;
+	int numBytes, samplePosition;
+
+	while (it.getNextEvent(data, numBytes, samplePosition))
+		pool.addToView(0, pool.addEvent(data, numBytes, 0));
+
+	zoneConfigurationPending = false;
+}
+
+int MidiRouter::toMpeBend(float offsetCents) const noexcept
+{
+	// The player's own pitch wheel goes to the master channel, so member
+	// channels only carry the tuning offset.
+	return jlimit(0, 16383, 8192 + roundToInt(offsetCents * 0.01f / (float)preparedPitchbendRange * 8192.0f));
+}
+
+int MidiRouter::allocateMemberChannel(int samplePosition) noexcept
+{
+	const uint32 freeChannels = memberChannelMask & ~occupiedChannels & ~reservedChannels;
+
+	if (freeChannels != 0)
+	{
+		// Lower zones fill upwards from the master channel, upper zones downwards.
+		return preparedLowerZone ? findHighestSetBit(freeChannels & (~freeChannels + 1u))
+		                         : findHighestSetBit(freeChannels);
+	}
+
+	// Steal the oldest channel, leaving the ones bent for upcoming notes alone if possible.
+	int oldest = -1;
+	for (int pass = 0; pass < 2 && oldest < 0; ++pass)
+	{
+		const uint32 candidates = pass == 0 ? memberChannelMask & ~reservedChannels : memberChannelMask;
+		for (int ch = 0; ch < 16; ++ch)
+			if ((candidates & (1 << ch)) != 0
+				&& (oldest < 0 || memberChannels[ch].lastUsed < memberChannels[oldest].lastUsed))
+				oldest = ch;
+	}
+
+	// Every member channel carries one note, which has to end before the
+	// channel is bent for the next one.
+	if (oldest >= 0 && memberChannels[oldest].numNotes > 0)
+	{
+		const auto& member = memberChannels[oldest];
+		if (member.lastNote >= 0 && noteChannel[member.inputChannel][member.lastNote] == oldest)
+		{
+			const uint8 noteOff[] = { (uint8)(0x80 | member.inputChannel), (uint8)member.lastNote, 0 };
+			routeEvent(noteOff, 3, samplePosition, -1);
+		}
+	}
+
+	return oldest;
+}
+
+void MidiRouter::sendMemberBend(int channel, int bend, int samplePosition) noexcept
+{
+	auto& member = memberChannels[channel];
+	if (member.bend == bend)
+		return;
+
+	member.bend = bend;
+	pool.addToView(0, pool.addShortEvent((uint8)(0xe0 | channel), (uint8)(bend & 0x7f), (uint8)((bend >> 7) & 0x7f), samplePosition));
+}
+
+void MidiRouter::forwardToMemberChannels(const uint8* data, int numBytes, int samplePosition) noexcept
+{
+	const auto inputChannel = data[0] & 0x0f;
+
+	for (uint32 bits = occupiedChannels; bits != 0; bits &= bits - 1)
+	{
+		const auto ch = findHighestSetBit(bits & (~bits + 1u));
+		if (memberChannels[ch].inputChannel != inputChannel)
+			continue;
+
+		const auto index = pool.addEvent(data, numBytes, samplePosition);
+		pool.setChannel(index, ch);
+		pool.addToView(0, index);
+	}
+}
+
+void MidiRouter::handleMpeEvent(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept
+{
+	const auto status = data[0] & 0xf0;
+	const auto inputChannel = data[0] & 0x0f;
+
+	if ((status == 0x80 || status == 0x90) && numBytes >= 3)
+	{
+		const auto note = data[1] & 0x7f;
+		auto ch = (int)noteChannel[inputChannel][note];
+
+		if (status == 0x90 && data[2] > 0)
+		{
+			if (voiceLimit > 0 && numSoundingNotes >= voiceLimit && ch < 0)
+				releaseQuietestNote(samplePosition);
+
+			if (isPositiveAndBelow(reservation, 16))
+				reservedChannels &= (uint16)~(1 << reservation);
+			else
+				reservation = -1;
+
+			if (ch < 0)
+			{
+				ch = reservation >= 0 ? reservation : allocateMemberChannel(samplePosition);
+				if (ch < 0)
+					return;
+
+				noteChannel[inputChannel][note] = (int8)ch;
+				occupiedChannels |= (uint16)(1 << ch);
+				memberChannels[ch].numNotes++;
+				numSoundingNotes++;
+			}
+
+			soundingNotes.add(inputChannel, note, data[2]);
+
+			// With portamento the new note starts at the previous note's pitch
+			// and glides to its own, as far as the bend range allows.
+			const auto target = noteOffsets[note];
+			auto start = target;
+			const auto portamentoSamples = getGlideSamples(portamentoMs.load());
+
+			if (portamentoSamples > 0 && lastPlayedNote >= 0 && lastPlayedNote != note)
+			{
+				const auto limit = (float)preparedPitchbendRange * 100.0f;
+				start = jlimit(-limit, limit, (float)(lastPlayedNote - note) * 100.0f + noteOffsets[lastPlayedNote]);
+				glides.startGlide(ch, start, target, blockStartSample + samplePosition, portamentoSamples, (GlideEngine::Shape)glideShape.load());
+			}
+			else
+			{
+				glides.stopGlide(ch);
+			}
+
+			auto& member = memberChannels[ch];
+			member.inputChannel = inputChannel;
+			member.lastUsed = ++noteCounter;
+			member.lastNote = note;
+			member.currentCents = start;
+			lastPlayedNote = note;
+			sendMemberBend(ch, toMpeBend(start), samplePosition);
+		}
+		else
+		{
+			if (ch < 0)
+				return;
+
+			noteChannel[inputChannel][note] = -1;
+			soundingNotes.remove(inputChannel, note);
+			numSoundingNotes = jmax(0, numSoundingNotes - 1);
+			auto& member = memberChannels[ch];
+			member.numNotes = jmax(0, member.numNotes - 1);
+			if (member.numNotes == 0)
+				occupiedChannels &= (uint16)~(1 << ch);
+		}
+
+		const auto index = pool.addEvent(data, numBytes, samplePosition);
+		pool.setChannel(index, ch);
+		pool.addToView(0, index);
+	}
+	else if (status == 0xa0 && numBytes >= 3)
+	{
+		// Polyphonic aftertouch becomes channel pressure on the note's channel.
+		const auto ch = (int)noteChannel[inputChannel][data[1] & 0x7f];
+		if (ch >= 0)
+		{
+			const uint8 pressure[] = { (uint8)(0xd0 | ch), data[2] };
+			pool.addToView(0, pool.addEvent(pressure, 2, samplePosition));
+		}
+	}
+	else if (status == 0xd0 || (status == 0xb0 && numBytes >= 3 && data[1] == 74))
+	{
+		// Pressure and timbre follow the notes that came in on this channel.
+		forwardToMemberChannels(data, numBytes, samplePosition);
+	}
+	else
+	{
+		const auto index = pool.addEvent(data, numBytes, samplePosition);
+		pool.setChannel(index, masterChannel);
+		pool.addToView(0, index);
+	}
+}
+
+//==============================================================================
+void MidiRouter::SoundingNotes::clear() noexcept
+{
+	std::fill(std::begin(head), std::end(head), (int16)-1);
+	std::fill(std::begin(tail), std::end(tail), (int16)-1);
+	std::fill(std::begin(velocities), std::end(velocities), (uint8)0);
+	std::fill(std::begin(usedVelocities), std::end(usedVelocities), 0u);
+}
+
+void MidiRouter::SoundingNotes::add(int channel, int note, int velocity) noexcept
+{
+	remove(channel, note);
+
+	const auto key = (int16)(channel * 128 + note);
+	const auto v = jlimit(1, 127, velocity);
+
+	previous[key] = tail[v];
+	next[key] = -1;
+
+	if (tail[v] >= 0)
+		next[tail[v]] = key;
+	else
+		head[v] = key;
+
+	tail[v] = key;
+	velocities[key] = (uint8)v;
+	usedVelocities[v >> 5] |= 1u << (v & 31);
+}
+
+void MidiRouter::SoundingNotes::remove(int channel, int note) noexcept
+{
+	const auto key = channel * 128 + note;
+	const auto v = (int)velocities[key];
+	if (v == 0)
+		return;
+
+	if (previous[key] >= 0)
+		next[previous[key]] = next[key];
+	else
+		head[v] = next[key];
+
+	if (next[key] >= 0)
+		previous[next[key]] = previous[key];
+	else
+		tail[v] = previous[key];
+
+	velocities[key] = 0;
+	if (head[v] < 0)
+		usedVelocities[v >> 5] &= ~(1u << (v & 31));
+}
+
+bool MidiRouter::SoundingNotes::findQuietest(int& channel, int& note) const noexcept
+{
+	for (int word = 0; word < 4; ++word)
+	{
+		const auto bits = usedVelocities[word];
+		if (bits == 0)
+			continue;
+
+		const auto key = (int)head[word * 32 + findHighestSetBit(bits & (~bits + 1u))];
+		channel = key >> 7;
+		note = key & 127;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    MidiRouter.h
+    Created: 19 Oct 2026 11:20:05am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MidiEventPool.h"
+#include "GlideEngine.h"
+#include "LookaheadQueue.h"
+#include "AdaptiveTuning.h"
+
+//==============================================================================
+/**
+    Spreads the incoming MIDI stream over the backend instances.
+
+    Every note is given to an instance whose pitch bend already matches the
+    note's tuning offset, or to a free one which is then re-bent. Notes and
+    polyphonic aftertouch go to a single view, everything else is broadcast.
+    All channel voice messages are remapped in place to the output channel.
+
+    In MPE mode there is a single instance instead: each note gets its own
+    member channel in the configured zone, carrying the tuning offset as
+    per-note pitch bend together with its pressure and timbre.
+
+    Retuning sounding notes, and in MPE mode moving from one note to the
+    next, can glide instead of jumping; the bends are then produced by the
+    GlideEngine at an adaptive rate.
+
+    With adaptive tuning on, the static offsets are set aside and every
+    note-on and note-off updates an AdaptiveTuning engine instead. When it
+    moves the root, the sounding notes are retuned from that sample on,
+    gliding if a retune glide is set.
+
+    Under load the processor can ask for glide bends to be sent more
+    sparsely, and for a limit on sounding notes; notes over the limit are
+    released quietest first, by velocity.
+
+    With a lookahead set, every event is held back by that many samples.
+    Note-ons are seen as they arrive, so a free instance or member channel
+    can be reserved and bent in advance; the note then lands on a backend
+    that is already in tune instead of sharing its sample with the bend.
+*/
+class MidiRouter
+{
+public:
+	enum class OutputMode
+	{
+		clones = 0,
+		mpe
+	};
+
+	MidiRouter(MidiEventPool& pool);
+	~MidiRouter();
+
+	void prepare(int numInstances, double sampleRate, int samplesPerBlock);
+	void reset() noexcept;
+
+	//==============================================================================
+	void setNoteOffsets(const Array<float>& centsPerNote);
+	void setPitchBendRange(float semitones);
+	void setBendTuningEnabled(bool shouldInsertBends);
+
+	/** These only take effect on the next prepare(). */
+	void setOutputMode(OutputMode newMode);
+	void setMpeZone(bool useLowerZone, int numMemberChannels, int perNotePitchbendRange);
+	OutputMode getOutputMode() const noexcept { return outputMode; }
+	void setLookahead(int samples);
+	int getLookahead() const noexcept { return lookaheadSamples; }
+
+	void setGlide(float retuneMs, float portamentoMs, GlideEngine::Shape shape);
+	void setCustomGlideShape(float a, float b);
+
+	/** Overrides the retune glide time for the next tuning change only. */
+	void setNextRetuneGlide(float ms);
+
+	void setAdaptiveTuning(bool shouldAdapt, float driftLimitCents);
+	bool isAdaptiveTuningEnabled() const noexcept { return adaptiveTuningEnabled.load(); }
+
+	//==============================================================================
+	/** Audio thread. A limit of 0 means none. */
+	void setCoarseGlides(bool shouldUseCoarseGlides) noexcept { coarseGlides = shouldUseCoarseGlides; }
+	void setVoiceLimit(int maxSoundingNotes) noexcept { voiceLimit = jmax(0, maxSoundingNotes); }
+	int getVoiceLimit() const noexcept { return voiceLimit; }
+	int getNumSoundingNotes() const noexcept { return numSoundingNotes; }
+
+	//==============================================================================
+	void process(const MidiBuffer& input, int numSamples) noexcept;
+
+private:
+	//==============================================================================
+	struct InstanceState
+	{
+		float offsetCents = 0.0f;
+		float currentCents = 0.0f;
+		int lastNote = -1;
+		int bend = 8192;
+		int numNotes = 0;
+		int numReserved = 0;
+		int64 lastUsed = 0;
+	};
+
+	void routeEvent(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept;
+	void dispatchEvent(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept;
+	bool isSounding(int channel, int note) const noexcept;
+	void processWithLookahead(const MidiBuffer& input, int numSamples) noexcept;
+	int reserveForNote(const uint8* data, int numBytes, int samplePosition) noexcept;
+	void cancelReservation(int reservation) noexcept;
+
+	int toBend(float offsetCents) const noexcept;
+	int allocateInstance(float offsetCents) noexcept;
+	void sendBend(int instance, int bend, int samplePosition) noexcept;
+	void handleNoteOn(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept;
+	void handleNoteOff(const uint8* data, int numBytes, int samplePosition) noexcept;
+	void handlePitchWheel(const uint8* data, int samplePosition) noexcept;
+	bool pullPendingNoteOffsets() noexcept;
+	bool pullAdaptiveTuningSettings() noexcept;
+	void refreshNoteOffsets() noexcept;
+	void retuneSoundingNotes(int samplePosition) noexcept;
+	void renderGlides(int numSamples) noexcept;
+	int getGlideSamples(float ms) const noexcept;
+	void updateGlideResolution() noexcept;
+	void releaseQuietestNote(int samplePosition) noexcept;
+
+	void sendZoneConfiguration() noexcept;
+	int toMpeBend(float offsetCents) const noexcept;
+	int allocateMemberChannel(int samplePosition) noexcept;
+	void sendMemberBend(int channel, int bend, int samplePosition) noexcept;
+	void forwardToMemberChannels(const uint8* data, int numBytes, int samplePosition) noexcept;
+	void handleMpeEvent(const uint8* data, int numBytes, int samplePosition, int reservation) noexcept;
+
+	/** The sounding notes in one list per velocity, oldest first, so the quietest is found without a scan. */
+	struct SoundingNotes
+	{
+		void clear() noexcept;
+		void add(int channel, int note, int velocity) noexcept;
+		void remove(int channel, int note) noexcept;
+		bool findQuietest(int& channel, int& note) const noexcept;
+
+		int16 next[16 * 128], previous[16 * 128];
+		int16 head[128], tail[128];
+		uint8 velocities[16 * 128];
+		uint32 usedVelocities[4];
+	};
+
+	//==============================================================================
+	MidiEventPool& pool;
+	Array<InstanceState> instances;
+	int8 noteInstance[16][128];
+	SoundingNotes soundingNotes;
+	int64 noteCounter = 0;
+	int numSoundingNotes = 0, voiceLimit = 0;
+
+	float noteOffsets[128], staticOffsets[128];
+	float userBendSemitones = 0.0f;
+	std::atomic<float> pitchBendRange{ 2.0f };
+	std::atomic<bool> bendTuningEnabled{ true };
+
+	static constexpr int outputChannel = 0;
+
+	//==============================================================================
+	struct MemberChannelState
+	{
+		int bend = 8192;
+		int numNotes = 0;
+		int inputChannel = -1;
+		int lastNote = -1;
+		float currentCents = 0.0f;
+		int64 lastUsed = 0;
+	};
+
+	OutputMode outputMode = OutputMode::clones, preparedMode = OutputMode::clones;
+	bool mpeLowerZone = true, preparedLowerZone = true;
+	int mpeNumMemberChannels = 15, mpePitchbendRange = 48, preparedPitchbendRange = 48;
+	int masterChannel = 0;
+
+	uint16 memberChannelMask = 0, occupiedChannels = 0, reservedChannels = 0;
+	MemberChannelState memberChannels[16];
+	int8 noteChannel[16][128];
+	MidiBuffer zoneConfiguration;
+	bool zoneConfigurationPending = false;
+
+	//==============================================================================
+	GlideEngine glides;
+	double currentSampleRate = 44100.0;
+	int64 blockStartSample = 0;
+	int lastPlayedNote = -1;
+	bool coarseGlides = false, appliedCoarseGlides = false;
+
+	std::atomic<float> retuneGlideMs{ 0.0f }, portamentoMs{ 0.0f };
+	std::atomic<float> nextRetuneGlideMs{ -1.0f };
+	std::atomic<int> glideShape{ (int)GlideEngine::Shape::linear };
+	std::atomic<float> customGlideA{ 0.0f }, customGlideB{ 3.0f };
+
+	LookaheadQueue lookahead;
+	int lookaheadSamples = 0, preparedLookahead = 0;
+
+	AdaptiveTuning adaptiveTuning;
+	bool adaptiveTuningActive = false;
+	std::atomic<bool> adaptiveTuningEnabled{ false };
+	std::atomic<float> adaptiveDriftCents{ 20.0f };
+
+	Array<float> pendingNoteOffsets;
+	std::atomic<bool> noteOffsetsChanged{ false };
+	SpinLock noteOffsetLock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiRouter)
+};
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    ParameterProxy.cpp
+    Created: 19 Oct 2026 10:24:13pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "ParameterProxy.h"
+
+const Identifier ParameterProxyPool::mappingsType("ProxyMappings");
+
+namespace
+{
+	const Identifier mappingType("Mapping");
+	const Identifier slotId("slot");
+	const Identifier targetId("target");
+	const Identifier nameId("name");
+
+	// Never a normalised value, so the next forward() sends whatever is there.
+	constexpr float notSent = -1.0f;
+}
+
+//==============================================================================
+ProxyParameter::ProxyParameter(int s)
+	: AudioParameterFloat(ParameterProxyPool::getParameterID(s), "Proxy " + String(s + 1), 0.0f, 1.0f, 0.0f),
+	  slot(s)
+{
+}
+
+void ProxyParameter::setTarget(int backendParameterIndex, const String& backendParameterName)
+{
+	{
+		const ScopedLock sl(nameLock);
+		targetName = backendParameterIndex >= 0 ? backendParameterName : String();
+	}
+
+	target = backendParameterIndex;
+}
+
+String ProxyParameter::getName(int maximumStringLength) const
+{
+	const ScopedLock sl(nameLock);
+	const auto name = targetName.isNotEmpty() ? targetName : "Proxy " + String(slot + 1);
+	return name.substring(0, maximumStringLength);
+}
+
+//==============================================================================
+ParameterProxyPool::ParameterProxyPool()
+{
+	std::fill(std::begin(lastSent), std::end(lastSent), notSent);
+}
+
+ParameterProxyPool::~ParameterProxyPool()
+{
+}
+
+void ParameterProxyPool::addToLayout(AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+	for (int slot = 0; slot < numProxies; ++slot)
+		layout.add(std::make_unique<ProxyParameter>(slot));
+}
+
+String ParameterProxyPool::getParameterID(int slot)
+{
+	return "proxy" + String(slot + 1);
+}
+
+void ParameterProxyPool::attach(AudioProcessorValueTreeState& state)
+{
+	proxies.clearQuick();
+	for (int slot = 0; slot < numProxies; ++slot)
+	{
+		auto* proxy = dynamic_cast<ProxyParameter*>(state.getParameter(getParameterID(slot)));
+		jassert(proxy != nullptr);
+		proxies.add(proxy);
+	}
+}
+
+//==============================================================================
+bool ParameterProxyPool::map(int slot, int backendParameterIndex, AudioProcessor& backend)
+{
+	auto* proxy = proxies[slot];
+	auto* parameter = backend.getParameters()[backendParameterIndex];
+	if (proxy == nullptr || parameter == nullptr)
+		return false;
+
+	// A parameter is driven by one proxy at most, or the two would fight.
+	const auto previous = findSlotFor(backendParameterIndex);
+	if (previous >= 0 && previous != slot)
+		unmap(previous);
+
+	// Start from where the backend is, so mapping does not make it jump.
+	proxy->setTarget(backendParameterIndex, parameter->getName(128));
+	proxy->setValueNotifyingHost(parameter->getValue());
+
+	invalidate();
+	return true;
+}
+
+void ParameterProxyPool::unmap(int slot)
+{
+	if (auto* proxy = proxies[slot])
+		proxy->setTarget(-1, {});
+}
+
+void ParameterProxyPool::unmapAll()
+{
+	for (int slot = 0; slot < proxies.size(); ++slot)
+		unmap(slot);
+}
+
+int ParameterProxyPool::getTarget(int slot) const noexcept
+{
+	auto* proxy = proxies[slot];
+	return proxy != nullptr ? proxy->getTarget() : -1;
+}
+
+int ParameterProxyPool::findSlotFor(int backendParameterIndex) const noexcept
+{
+	for (int slot = 0; slot < proxies.size(); ++slot)
+		if (proxies.getUnchecked(slot)->getTarget() == backendParameterIndex)
+			return slot;
+	return -1;
+}
+
+int ParameterProxyPool::findFreeSlot() const noexcept
+{
+	return findSlotFor(-1);
+}
+
+void ParameterProxyPool::invalidate() noexcept
+{
+	needsResend = true;
+}
+
+//==============================================================================
+void ParameterProxyPool::forward(AudioProcessor* const* backends, int numBackends) noexcept
+{
+	if (needsResend.exchange(false))
+		std::fill(std::begin(lastSent), std::end(lastSent), notSent);
+
+	for (int slot = 0; slot < proxies.size(); ++slot)
+	{
+		auto* proxy = proxies.getUnchecked(slot);
+		const auto target = proxy->getTarget();
+		if (target < 0)
+			continue;
+
+		const auto value = proxy->getValue();
+		if (value == lastSent[slot])
+			continue;
+
+		lastSent[slot] = value;
+
+		for (int i = 0; i < numBackends; ++i)
+			if (auto* parameter = backends[i]->getParameters()[target])
+				parameter->setValue(value);
+	}
+}
+
+//==============================================================================
+ValueTree ParameterProxyPool::toValueTree() const
+{
+	ValueTree tree(mappingsType);
+
+	for (int slot = 0; slot < proxies.size(); ++slot)
+	{
+		auto* proxy = proxies.getUnchecked(slot);
+		if (proxy->getTarget() < 0)
+			continue;
+
+		ValueTree mapping(mappingType);
+		mapping.setProperty(slotId, slot, nullptr);
+		mapping.setProperty(targetId, proxy->getTarget(), nullptr);
+		mapping.setProperty(nameId, proxy->getName(128), nullptr);
+		tree.appendChild(mapping, nullptr);
+	}
+
+	return tree;
+}
+
+void ParameterProxyPool::fromValueTree(const ValueTree& tree)
+{
+	unmapAll();
+
+	for (const auto& mapping : tree)
+		if (auto* proxy = proxies[(int)mapping[slotId]])
+			proxy->setTarget(mapping.getProperty(targetId, -1), mapping[nameId].toString());
+
+	invalidate();
+}
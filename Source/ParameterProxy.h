@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ParameterProxy.h
+    Created: 19 Oct 2026 10:24:13pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A host-visible parameter that stands in for one parameter of the backend.
+
+    The host sees a fixed set of these from the start, since most hosts do
+    not cope with parameters appearing later; what each one controls is
+    chosen at runtime. Until it is mapped the proxy is called "Proxy N".
+*/
+class ProxyParameter : public AudioParameterFloat
+{
+public:
+	ProxyParameter(int slot);
+
+	/** The backend parameter index this proxy drives, or -1. */
+	int getTarget() const noexcept { return target.load(); }
+
+	/** Message thread. */
+	void setTarget(int backendParameterIndex, const String& backendParameterName);
+
+	String getName(int maximumStringLength) const override;
+
+private:
+	const int slot;
+	std::atomic<int> target{ -1 };
+
+	String targetName;
+	CriticalSection nameLock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProxyParameter)
+};
+
+//==============================================================================
+/**
+    The fixed pool of proxy parameters, and the forwarding of their values to
+    every backend instance.
+
+    Each slot's target is a single atomic index into the backend's parameter
+    list, so forwarding a value is a plain loop over the instances with no
+    lookups by ID and no locks. Values are forwarded before the graph renders,
+    so every clone sees a change from the same sample on.
+*/
+class ParameterProxyPool
+{
+public:
+	static constexpr int numProxies = 64;
+
+	ParameterProxyPool();
+	~ParameterProxyPool();
+
+	//==============================================================================
+	/** Adds the proxies to the processor's parameter layout. */
+	static void addToLayout(AudioProcessorValueTreeState::ParameterLayout& layout);
+	static String getParameterID(int slot);
+
+	/** Finds the proxies in the state once it has been created. */
+	void attach(AudioProcessorValueTreeState& state);
+
+	//==============================================================================
+	/** Message thread. The backend is used for the parameter's name and current value. */
+	bool map(int slot, int backendParameterIndex, AudioProcessor& backend);
+	void unmap(int slot);
+	void unmapAll();
+
+	int getTarget(int slot) const noexcept;
+	int findSlotFor(int backendParameterIndex) const noexcept;
+	int findFreeSlot() const noexcept;
+	ProxyParameter* getProxy(int slot) const noexcept { return proxies[slot]; }
+
+	/** Makes the next forward() send every mapped value again, e.g. to fresh instances. */
+	void invalidate() noexcept;
+
+	//==============================================================================
+	/** Audio thread: sends values that changed since the last call to every backend. */
+	void forward(AudioProcessor* const* backends, int numBackends) noexcept;
+
+	//==============================================================================
+	ValueTree toValueTree() const;
+	void fromValueTree(const ValueTree& tree);
+
+	static const Identifier mappingsType;
+
+private:
+	//==============================================================================
+	Array<ProxyParameter*> proxies;
+	float lastSent[numProxies];
+	std::atomic<bool> needsResend{ true };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterProxyPool)
+};
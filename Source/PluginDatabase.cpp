@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    PluginDatabase.cpp
+    Created: 19 Oct 2026 7:48:15pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "PluginDatabase.h"
+
+//==============================================================================
+class PluginDatabase::Loader : public Thread
+{
+public:
+	Loader(PluginDatabase& o) : Thread("MicroChromo Plugin List"), owner(o) {}
+
+	~Loader() override
+	{
+		stopThread(5000);
+	}
+
+	void run() override
+	{
+		// Opening the settings file parses all of it, plugin list included,
+		// so that happens here as well.
+		auto* settings = owner.appProperties.getUserSettings();
+
+		if (auto savedPluginList = settings->getXmlValue("pluginList"))
+			if (!threadShouldExit())
+				owner.knownPluginList.recreateFromXml(*savedPluginList);
+
+		owner.sortMethod = (KnownPluginList::SortMethod)settings->getIntValue("pluginSortMethod", KnownPluginList::sortByManufacturer);
+
+		if (!threadShouldExit())
+			owner.index.rebuild(owner.knownPluginList);
+
+		owner.triggerAsyncUpdate();
+	}
+
+private:
+	PluginDatabase& owner;
+};
+
+//==============================================================================
+PluginDatabase::PluginDatabase()
+{
+	PropertiesFile::Options options;
+	options.folderName = "MicroChromo";
+	options.applicationName = "MicroChromo Host";
+	options.filenameSuffix = "settings";
+	options.osxLibrarySubFolder = "Preferences";
+
+	appProperties.setStorageParameters(options);
+}
+
+PluginDatabase::~PluginDatabase()
+{
+	loader = nullptr;
+	cancelPendingUpdate();
+	knownPluginList.removeChangeListener(this);
+
+	// Changes still waiting for their batch are saved all the same.
+	if (isTimerRunning())
+	{
+		stopTimer();
+		savePluginList();
+	}
+
+	appProperties.saveIfNeeded();
+}
+
+void PluginDatabase::loadAsync()
+{
+	if (loader != nullptr)
+		return;
+
+	loader.reset(new Loader(*this));
+	loader->startThread(3);
+}
+
+AudioPluginFormatManager& PluginDatabase::getFormatManager()
+{
+	const ScopedLock sl(formatLock);
+	if (formatManager.getNumFormats() == 0)
+		formatManager.addDefaultFormats();
+
+	return formatManager;
+}
+
+void PluginDatabase::setSortMethod(KnownPluginList::SortMethod newMethod)
+{
+	if (sortMethod == newMethod)
+		return;
+
+	sortMethod = newMethod;
+	appProperties.getUserSettings()->setValue("pluginSortMethod", (int)sortMethod);
+	appProperties.saveIfNeeded();
+	sendChangeMessage();
+}
+
+//==============================================================================
+void PluginDatabase::handleAsyncUpdate()
+{
+	// Only listen from here on, so loading the list does not write it back.
+	loaded = true;
+	knownPluginList.addChangeListener(this);
+	sendChangeMessage();
+}
+
+void PluginDatabase::changeListenerCallback(ChangeBroadcaster* changed)
+{
+	// Later changes join the batch the first one started.
+	if (changed == &knownPluginList && !isTimerRunning())
+		startTimer(updateIntervalMs);
+}
+
+void PluginDatabase::timerCallback()
+{
+	stopTimer();
+	savePluginList();
+	index.update(knownPluginList);
+	sendChangeMessage();
+}
+
+void PluginDatabase::savePluginList()
+{
+	if (auto savedPluginList = std::unique_ptr<XmlElement>(knownPluginList.createXml()))
+	{
+		appProperties.getUserSettings()->setValue("pluginList", savedPluginList.get());
+		appProperties.saveIfNeeded();
+	}
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    PluginDatabase.h
+    Created: 19 Oct 2026 7:48:15pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "PluginIndex.h"
+
+//==============================================================================
+/**
+    The plugin formats, settings file and known plugin list, shared by every
+    processor and editor in the process through a SharedResourcePointer.
+
+    Nothing is read when it is created. loadAsync() parses the settings and
+    the saved plugin list on a background thread, and a change message goes
+    out on the message thread once the list can be used. The formats are
+    only registered the first time somebody asks for the format manager.
+
+    A search index over the list is built on the loader thread too, and
+    kept up to date on the message thread as plugins are scanned or removed.
+    Changes to the list are taken up in batches, at most every
+    updateIntervalMs, so a scan finding thousands of plugins does not save
+    the list and update the index once for each of them.
+*/
+class PluginDatabase : public ChangeBroadcaster,
+                       private ChangeListener,
+                       private AsyncUpdater,
+                       private Timer
+{
+public:
+	PluginDatabase();
+	~PluginDatabase();
+
+	//==============================================================================
+	/** Starts loading the plugin list, if that has not been done yet. */
+	void loadAsync();
+	bool isLoaded() const noexcept { return loaded; }
+
+	/** Message thread only. The list must not be touched before isLoaded() returns true. */
+	KnownPluginList& getKnownPluginList() noexcept { return knownPluginList; }
+	KnownPluginList::SortMethod getSortMethod() const noexcept { return sortMethod; }
+	void setSortMethod(KnownPluginList::SortMethod newMethod);
+
+	/** Message thread only, once isLoaded() returns true. */
+	const PluginIndex& getIndex() const noexcept { return index; }
+
+	AudioPluginFormatManager& getFormatManager();
+	ApplicationProperties& getAppProperties() noexcept { return appProperties; }
+
+	static constexpr int updateIntervalMs = 250;
+
+private:
+	//==============================================================================
+	class Loader;
+
+	void changeListenerCallback(ChangeBroadcaster*) override;
+	void handleAsyncUpdate() override;
+	void timerCallback() override;
+	void savePluginList();
+
+	AudioPluginFormatManager formatManager;
+	ApplicationProperties appProperties;
+	KnownPluginList knownPluginList;
+	PluginIndex index;
+	KnownPluginList::SortMethod sortMethod = KnownPluginList::sortByManufacturer;
+
+	std::unique_ptr<Loader> loader;
+	std::atomic<bool> loaded{ false };
+	CriticalSection formatLock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginDatabase)
+};
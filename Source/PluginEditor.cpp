@@ -16,15 +16,16 @@
 class MicroChromoAudioProcessorEditor::PluginListWindow : public DocumentWindow
 {
 public:
-	PluginListWindow(MicroChromoAudioProcessorEditor &mw, AudioPluginFormatManager& pluginFormatManager)
+	PluginListWindow(MicroChromoAudioProcessorEditor &mw, PluginDatabase& database)
 		: DocumentWindow("Available Plugins",
 			LookAndFeel::getDefaultLookAndFeel().findColour(ResizableWindow::backgroundColourId),
 			DocumentWindow::minimiseButton | DocumentWindow::closeButton),
 		owner(mw)
 	{
-		auto deadMansPedalFile = owner.appProperties->getUserSettings()->getFile().getSiblingFile("RecentlyCrashedPluginsList");
+		auto* settings = database.getAppProperties().getUserSettings();
+		auto deadMansPedalFile = settings->getFile().getSiblingFile("RecentlyCrashedPluginsList");
 
-		setContentOwned(new PluginListComponent(pluginFormatManager, owner.knownPluginList, deadMansPedalFile, owner.appProperties->getUserSettings(), true), true);
+		setContentOwned(new PluginListComponent(database.getFormatManager(), database.getKnownPluginList(), deadMansPedalFile, settings, true), true);
 
 		setResizable(true, false);
 		setResizeLimits(300, 400, 800, 1500);
@@ -51,53 +52,78 @@ private:
 MicroChromoAudioProcessorEditor::MicroChromoAudioProcessorEditor (MicroChromoAudioProcessor& p)
     : AudioProcessorEditor (&p), processor (p)
 {
-	PropertiesFile::Options options;
-	options.folderName = "MicroChromo";
-	options.applicationName = "MicroChromo Host";
-	options.filenameSuffix = "settings";
-	options.osxLibrarySubFolder = "Preferences";
-
-	appProperties.reset(new ApplicationProperties());
-	appProperties->setStorageParameters(options);
-
-	formatManager.addDefaultFormats();
-    setSize (400, 300);
+    setSize (500, 400);
 
 	button1.reset(new TextButton("test"));
 	addAndMakeVisible(button1.get());
 	button1->addListener(this);
 	button1->setBounds(10, 10, 100, 50);
 
-	if (auto savedPluginList = appProperties->getUserSettings()->getXmlValue("pluginList"))
-		knownPluginList.recreateFromXml(*savedPluginList);
-	pluginSortMethod = (KnownPluginList::SortMethod)(appProperties->getUserSettings()->getIntValue("pluginSortMethod", KnownPluginList::sortByManufacturer));
-	knownPluginList.addChangeListener(this);
+	searchBox.reset(new TextEditor("search"));
+	addAndMakeVisible(searchBox.get());
+	searchBox->setTextToShowWhenEmpty("Search plugins", Colours::grey);
+	searchBox->addListener(this);
+
+	// Item IDs are the sort methods plus one, as ComboBox reserves zero.
+	sortBox.reset(new ComboBox("sort"));
+	addAndMakeVisible(sortBox.get());
+	sortBox->addItem("Default order", KnownPluginList::defaultOrder + 1);
+	sortBox->addItem("By name", KnownPluginList::sortAlphabetically + 1);
+	sortBox->addItem("By category", KnownPluginList::sortByCategory + 1);
+	sortBox->addItem("By manufacturer", KnownPluginList::sortByManufacturer + 1);
+	sortBox->addItem("By format", KnownPluginList::sortByFormat + 1);
+	sortBox->addItem("By location", KnownPluginList::sortByFileSystemLocation + 1);
+	sortBox->addItem("By last scanned", KnownPluginList::sortByInfoUpdateTime + 1);
+	sortBox->setSelectedId(pluginDatabase->getSortMethod() + 1, dontSendNotification);
+	sortBox->addListener(this);
+
+	pluginResults.reset(new ListBox("plugins", this));
+	addAndMakeVisible(pluginResults.get());
+
+	// The plugin list is read in the background; until then the editor is
+	// shown right away with the list button disabled.
+	button1->setEnabled(pluginDatabase->isLoaded());
+	pluginDatabase->addChangeListener(this);
+	pluginDatabase->loadAsync();
+	refreshPluginResults();
 
 	//AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Editor init", "INIT");
 }
 
 MicroChromoAudioProcessorEditor::~MicroChromoAudioProcessorEditor()
 {
-	knownPluginList.removeChangeListener(this);
+	pluginDatabase->removeChangeListener(this);
 
-	appProperties = nullptr;
 	pluginListWindow = nullptr;
+	pluginResults = nullptr;
+	sortBox = nullptr;
+	searchBox = nullptr;
 	button1 = nullptr;
 }
 
 //==============================================================================
 void MicroChromoAudioProcessorEditor::changeListenerCallback(ChangeBroadcaster* changed)
 {
-	if (changed == &knownPluginList)
+	if (changed == pluginDatabase.get())
 	{
-		if (auto savedPluginList = std::unique_ptr<XmlElement>(knownPluginList.createXml()))
-		{
-			appProperties->getUserSettings()->setValue("pluginList", savedPluginList.get());
-			appProperties->saveIfNeeded();
-		}
+		button1->setEnabled(pluginDatabase->isLoaded());
+		sortBox->setSelectedId(pluginDatabase->getSortMethod() + 1, dontSendNotification);
+		refreshPluginResults();
+		repaint();
 	}
 }
 
+void MicroChromoAudioProcessorEditor::refreshPluginResults()
+{
+	if (pluginDatabase->isLoaded())
+		pluginDatabase->getIndex().search(searchBox->getText(), pluginDatabase->getSortMethod(), true, visiblePlugins);
+	else
+		visiblePlugins.clear();
+
+	pluginResults->updateContent();
+	pluginResults->repaint();
+}
+
 //==============================================================================
 void MicroChromoAudioProcessorEditor::paint (Graphics& g)
 {
@@ -106,13 +132,21 @@ void MicroChromoAudioProcessorEditor::paint (Graphics& g)
 
     g.setColour (Colours::white);
     g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), Justification::centred, 1);
+    g.drawFittedText (pluginDatabase->isLoaded() ? String (pluginDatabase->getIndex().getNumPlugins()) + " plugins" : "Loading plugin list...", getLocalBounds().removeFromTop (70).withTrimmedLeft (120), Justification::centred, 1);
 }
 
 void MicroChromoAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+	auto area = getLocalBounds().reduced(10);
+	area.removeFromTop(60);
+
+	auto searchRow = area.removeFromTop(24);
+	sortBox->setBounds(searchRow.removeFromRight(140));
+	searchRow.removeFromRight(6);
+	searchBox->setBounds(searchRow);
+
+	area.removeFromTop(6);
+	pluginResults->setBounds(area);
 }
 
 void MicroChromoAudioProcessorEditor::buttonClicked(Button* btn)
@@ -120,7 +154,49 @@ void MicroChromoAudioProcessorEditor::buttonClicked(Button* btn)
 	if (btn == button1.get())
 	{
 		if (pluginListWindow == nullptr)
-			pluginListWindow.reset(new PluginListWindow(*this, formatManager));
+			pluginListWindow.reset(new PluginListWindow(*this, *pluginDatabase));
 		pluginListWindow->toFront(true);
 	}
 }
+
+void MicroChromoAudioProcessorEditor::comboBoxChanged(ComboBox* box)
+{
+	if (box == sortBox.get() && sortBox->getSelectedId() > 0)
+		pluginDatabase->setSortMethod((KnownPluginList::SortMethod)(sortBox->getSelectedId() - 1));
+}
+
+void MicroChromoAudioProcessorEditor::textEditorTextChanged(TextEditor& editor)
+{
+	if (&editor == searchBox.get())
+		refreshPluginResults();
+}
+
+//==============================================================================
+int MicroChromoAudioProcessorEditor::getNumRows()
+{
+	return (int)visiblePlugins.size();
+}
+
+void MicroChromoAudioProcessorEditor::paintListBoxItem(int row, Graphics& g, int width, int height, bool rowIsSelected)
+{
+	if (!isPositiveAndBelow(row, (int)visiblePlugins.size()))
+		return;
+
+	if (rowIsSelected)
+		g.fillAll(getLookAndFeel().findColour(TextEditor::highlightColourId));
+
+	const auto& description = pluginDatabase->getIndex().getDescription(visiblePlugins[(size_t)row]);
+
+	g.setColour(getLookAndFeel().findColour(ListBox::textColourId));
+	g.setFont(height * 0.7f);
+	g.drawText(description.name, 4, 0, width * 3 / 5 - 8, height, Justification::centredLeft, true);
+
+	g.setColour(getLookAndFeel().findColour(ListBox::textColourId).withAlpha(0.6f));
+	g.drawText(description.manufacturerName + " - " + description.pluginFormatName, width * 3 / 5, 0, width * 2 / 5 - 4, height, Justification::centredRight, true);
+}
+
+void MicroChromoAudioProcessorEditor::listBoxItemDoubleClicked(int row, const MouseEvent&)
+{
+	if (isPositiveAndBelow(row, (int)visiblePlugins.size()))
+		processor.setBackend(pluginDatabase->getIndex().getDescription(visiblePlugins[(size_t)row]));
+}
@@ -20,7 +20,10 @@
 class MicroChromoAudioProcessorEditor  : 
 	public AudioProcessorEditor, 
 	public ChangeListener, 
-	public Button::Listener
+	public Button::Listener,
+	public ComboBox::Listener,
+	public TextEditor::Listener,
+	public ListBoxModel
 {
 public:
     MicroChromoAudioProcessorEditor (MicroChromoAudioProcessor&);
@@ -35,22 +38,31 @@ public:
 
 	//==============================================================================
 	void buttonClicked(Button* btn) override;
+	void comboBoxChanged(ComboBox* box) override;
+	void textEditorTextChanged(TextEditor& editor) override;
+
+	//==============================================================================
+	int getNumRows() override;
+	void paintListBoxItem(int row, Graphics& g, int width, int height, bool rowIsSelected) override;
+	void listBoxItemDoubleClicked(int row, const MouseEvent&) override;
 
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     MicroChromoAudioProcessor& processor;
-	AudioPluginFormatManager formatManager;
+	SharedResourcePointer<PluginDatabase> pluginDatabase;
 
-	std::unique_ptr<ApplicationProperties> appProperties;
+	void refreshPluginResults();
 
-	KnownPluginList knownPluginList;
-	KnownPluginList::SortMethod pluginSortMethod;
-	Array<PluginDescription> pluginDescriptions;
+	// IDs in the database's index of the plugins matching the search box.
+	std::vector<int> visiblePlugins;
 
 	class PluginListWindow;
 	std::unique_ptr<PluginListWindow> pluginListWindow;
 	std::unique_ptr<Button> button1;
+	std::unique_ptr<TextEditor> searchBox;
+	std::unique_ptr<ComboBox> sortBox;
+	std::unique_ptr<ListBox> pluginResults;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MicroChromoAudioProcessorEditor)
 };
@@ -0,0 +1,377 @@
+/*
+  ==============================================================================
+
+    PluginIndex.cpp
+    Created: 20 Oct 2026 12:20:45am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "PluginIndex.h"
+
+namespace
+{
+	// Past this many new plugins at once, the orders are re-sorted rather
+	// than inserted into one by one.
+	constexpr size_t maxInsertionsInPlace = 64;
+
+	constexpr uint64 charMask = 0x1fffff;
+	constexpr uint64 prefixFlag = (uint64)1 << 63;
+
+	inline uint64 trigram(juce_wchar a, juce_wchar b, juce_wchar c) noexcept
+	{
+		return (((uint64)a & charMask) << 42) | (((uint64)b & charMask) << 21) | ((uint64)c & charMask);
+	}
+
+	inline uint64 prefixGram(juce_wchar a, juce_wchar b) noexcept
+	{
+		return prefixFlag | (((uint64)a & charMask) << 21) | ((uint64)b & charMask);
+	}
+
+	String createSearchKey(const PluginDescription& description)
+	{
+		// The separators keep a word from matching across two fields.
+		return (description.name + "\n" + description.manufacturerName + "\n"
+			+ description.category + "\n" + description.pluginFormatName).toLowerCase();
+	}
+
+	String lastPathPart(const String& path)
+	{
+		return path.replaceCharacter('\\', '/').upToLastOccurrenceOf("/", false, false);
+	}
+
+	void intersect(std::vector<int>& target, const std::vector<int>& other)
+	{
+		target.erase(std::set_intersection(target.begin(), target.end(), other.begin(), other.end(), target.begin()), target.end());
+	}
+}
+
+//==============================================================================
+PluginIndex::PluginIndex()
+{
+}
+
+PluginIndex::~PluginIndex()
+{
+}
+
+void PluginIndex::rebuild(const KnownPluginList& list)
+{
+	entries.clear();
+	idByIdentity.clear();
+	idBySource.clear();
+	postings.clear();
+	pendingInsertions.clear();
+	numLive = 0;
+
+	for (auto& order : orders)
+		order.clear();
+
+	entries.reserve((size_t)list.getNumTypes());
+	for (int i = 0; i < list.getNumTypes(); ++i)
+		add(list.getType(i));
+
+	sortOrders(true);
+}
+
+void PluginIndex::update(const KnownPluginList& list)
+{
+	std::vector<uint8> seen(entries.size(), 0);
+
+	for (int i = 0; i < list.getNumTypes(); ++i)
+	{
+		const auto* type = list.getType(i);
+
+		// A rescanned plugin whose details changed is replaced, since it may sort differently.
+		const auto bySource = idBySource.find(type);
+		if (bySource != idBySource.end() && isUnchanged(entries[(size_t)bySource->second], *type))
+		{
+			seen[(size_t)bySource->second] = 1;
+			continue;
+		}
+
+		const auto byIdentity = idByIdentity.find(type->createIdentifierString());
+		if (byIdentity != idByIdentity.end() && isUnchanged(entries[(size_t)byIdentity->second], *type))
+		{
+			auto& entry = entries[(size_t)byIdentity->second];
+			entry.source = type;
+			idBySource[type] = byIdentity->second;
+			seen[(size_t)byIdentity->second] = 1;
+			continue;
+		}
+
+		add(type);
+	}
+
+	auto anyRemoved = false;
+	for (size_t id = 0; id < seen.size(); ++id)
+	{
+		auto& entry = entries[id];
+		if (entry.removed || seen[id] != 0)
+			continue;
+
+		entry.removed = true;
+		--numLive;
+		anyRemoved = true;
+
+		const auto found = idByIdentity.find(entry.identity);
+		if (found != idByIdentity.end() && found->second == (int)id)
+			idByIdentity.erase(found);
+
+		// The address may already hold the plugin's replacement, or a new one.
+		const auto bySource = idBySource.find(entry.source);
+		if (bySource != idBySource.end() && bySource->second == (int)id)
+			idBySource.erase(bySource);
+	}
+
+	if ((size_t)numLive * 4 < entries.size() * 3)
+	{
+		rebuild(list);
+		return;
+	}
+
+	if (anyRemoved)
+		for (auto& order : orders)
+			order.erase(std::remove_if(order.begin(), order.end(), [this](int id) { return entries[(size_t)id].removed; }), order.end());
+
+	if (anyRemoved || !pendingInsertions.empty())
+		sortOrders(pendingInsertions.size() > maxInsertionsInPlace);
+}
+
+//==============================================================================
+void PluginIndex::add(const PluginDescription* type)
+{
+	const auto id = (int)entries.size();
+
+	Entry entry;
+	entry.description = *type;
+	entry.key = createSearchKey(*type);
+	entry.identity = type->createIdentifierString();
+	entry.source = type;
+	entries.push_back(entry);
+
+	idByIdentity[entries.back().identity] = id;
+	idBySource[type] = id;
+	addGrams(id);
+	pendingInsertions.push_back(id);
+	++numLive;
+}
+
+void PluginIndex::addGrams(int id)
+{
+	const auto chars = entries[(size_t)id].key.toUTF32();
+	const auto length = (int)chars.length();
+	const auto* text = chars.getAddress();
+
+	std::vector<uint64> grams;
+	grams.reserve((size_t)length * 2);
+
+	for (int i = 0; i < length; ++i)
+	{
+		if (text[i] == '\n')
+			continue;
+
+		if (i + 2 < length && text[i + 1] != '\n' && text[i + 2] != '\n')
+			grams.push_back(trigram(text[i], text[i + 1], text[i + 2]));
+
+		const auto startsWord = CharacterFunctions::isLetterOrDigit(text[i])
+			&& (i == 0 || !CharacterFunctions::isLetterOrDigit(text[i - 1]));
+
+		if (startsWord)
+		{
+			grams.push_back(prefixGram(text[i], 0));
+			if (i + 1 < length && CharacterFunctions::isLetterOrDigit(text[i + 1]))
+				grams.push_back(prefixGram(text[i], text[i + 1]));
+		}
+	}
+
+	std::sort(grams.begin(), grams.end());
+	grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+	// IDs only grow, so every list stays sorted.
+	for (auto gram : grams)
+		postings[gram].push_back(id);
+}
+
+bool PluginIndex::isUnchanged(const Entry& entry, const PluginDescription& description) noexcept
+{
+	// Addresses are reused once a description is freed, so the match is checked.
+	const auto& d = entry.description;
+	return !entry.removed && d.lastInfoUpdateTime == description.lastInfoUpdateTime && d.uid == description.uid
+		&& d.name == description.name && d.fileOrIdentifier == description.fileOrIdentifier
+		&& d.pluginFormatName == description.pluginFormatName;
+}
+
+//==============================================================================
+bool PluginIndex::isBefore(SortMethod method, int first, int second) const
+{
+	if (method == KnownPluginList::defaultOrder)
+		return first < second;
+
+	const auto& a = entries[(size_t)first].description;
+	const auto& b = entries[(size_t)second].description;
+	int diff = 0;
+
+	// The same ordering as KnownPluginList's own sorting.
+	switch (method)
+	{
+		case KnownPluginList::sortByCategory:           diff = a.category.compareNatural(b.category, false); break;
+		case KnownPluginList::sortByManufacturer:       diff = a.manufacturerName.compareNatural(b.manufacturerName, false); break;
+		case KnownPluginList::sortByFormat:             diff = a.pluginFormatName.compare(b.pluginFormatName); break;
+		case KnownPluginList::sortByFileSystemLocation: diff = lastPathPart(a.fileOrIdentifier).compare(lastPathPart(b.fileOrIdentifier)); break;
+		case KnownPluginList::sortByInfoUpdateTime:     diff = a.lastInfoUpdateTime < b.lastInfoUpdateTime ? -1 : (b.lastInfoUpdateTime < a.lastInfoUpdateTime ? 1 : 0); break;
+		case KnownPluginList::sortAlphabetically:
+		case KnownPluginList::defaultOrder:
+		default: break;
+	}
+
+	if (diff == 0)
+		diff = a.name.compareNatural(b.name, false);
+
+	return diff != 0 ? diff < 0 : first < second;
+}
+
+void PluginIndex::sortOrders(bool fully)
+{
+	for (int m = 0; m < numSortMethods; ++m)
+	{
+		const auto method = (SortMethod)m;
+		auto& order = orders[m];
+		auto before = [this, method](int first, int second) { return isBefore(method, first, second); };
+
+		if (fully)
+		{
+			order.insert(order.end(), pendingInsertions.begin(), pendingInsertions.end());
+			std::sort(order.begin(), order.end(), before);
+		}
+		else
+		{
+			for (auto id : pendingInsertions)
+				order.insert(std::upper_bound(order.begin(), order.end(), id, before), id);
+		}
+	}
+
+	pendingInsertions.clear();
+
+	for (auto& stale : ranksStale)
+		stale = true;
+}
+
+const std::vector<int>& PluginIndex::getRanks(int method) const
+{
+	auto& rank = ranks[method];
+	if (ranksStale[method])
+	{
+		rank.assign(entries.size(), -1);
+
+		const auto& order = orders[method];
+		for (size_t position = 0; position < order.size(); ++position)
+			rank[(size_t)order[position]] = (int)position;
+
+		ranksStale[method] = false;
+	}
+
+	return rank;
+}
+
+//==============================================================================
+const std::vector<int>* PluginIndex::findCandidates(const String& word, std::vector<int>& scratch) const
+{
+	const auto chars = word.toUTF32();
+	const auto length = (int)chars.length();
+	const auto* text = chars.getAddress();
+
+	if (length <= 2)
+	{
+		const auto found = postings.find(prefixGram(text[0], length > 1 ? text[1] : 0));
+		return found != postings.end() ? &found->second : nullptr;
+	}
+
+	// Start from the rarest trigram, so the intersections only ever shrink.
+	std::vector<const std::vector<int>*> lists;
+	for (int i = 0; i + 2 < length; ++i)
+	{
+		const auto found = postings.find(trigram(text[i], text[i + 1], text[i + 2]));
+		if (found == postings.end())
+			return nullptr;
+		lists.push_back(&found->second);
+	}
+
+	std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+	scratch = *lists.front();
+	for (size_t i = 1; i < lists.size() && !scratch.empty(); ++i)
+		intersect(scratch, *lists[i]);
+
+	return &scratch;
+}
+
+void PluginIndex::search(const String& query, SortMethod method, bool forwards, std::vector<int>& results) const
+{
+	results.clear();
+
+	const auto m = jlimit(0, numSortMethods - 1, (int)method);
+	const auto& order = orders[m];
+
+	auto words = StringArray::fromTokens(query.toLowerCase(), false);
+	words.removeEmptyStrings();
+
+	if (words.isEmpty())
+	{
+		results = order;
+	}
+	else
+	{
+		std::vector<int> scratch;
+		for (int w = 0; w < words.size(); ++w)
+		{
+			const auto* candidates = findCandidates(words[w], scratch);
+			if (candidates == nullptr)
+				return;
+
+			if (w == 0)
+				results = *candidates;
+			else
+				intersect(results, *candidates);
+
+			if (results.empty())
+				return;
+		}
+
+		// Trigrams can all be present without the word itself; short words are exact already.
+		results.erase(std::remove_if(results.begin(), results.end(), [this, &words](int id)
+		{
+			const auto& entry = entries[(size_t)id];
+			if (entry.removed)
+				return true;
+
+			for (auto& word : words)
+				if (word.length() > 2 && !entry.key.contains(word))
+					return true;
+
+			return false;
+		}), results.end());
+
+		if (results.size() * 8 > order.size())
+		{
+			// Most plugins matched: a pass over the order beats sorting them.
+			std::vector<uint8> matched(entries.size(), 0);
+			for (auto id : results)
+				matched[(size_t)id] = 1;
+
+			results.clear();
+			for (auto id : order)
+				if (matched[(size_t)id] != 0)
+					results.push_back(id);
+		}
+		else
+		{
+			const auto& rank = getRanks(m);
+			std::sort(results.begin(), results.end(), [&rank](int a, int b) { return rank[(size_t)a] < rank[(size_t)b]; });
+		}
+	}
+
+	if (!forwards)
+		std::reverse(results.begin(), results.end());
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    PluginIndex.h
+    Created: 20 Oct 2026 12:20:45am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <unordered_map>
+
+//==============================================================================
+/**
+    A search index over a KnownPluginList, for filtering and sorting large
+    plugin databases as fast as the user types.
+
+    Each plugin gets a lowercase search key made of its name, manufacturer,
+    category and format. Every trigram in a key, and the first one or two
+    characters of every word, maps to the sorted list of plugins that
+    contain it. A query word of three characters or more is looked up by
+    intersecting its trigrams' lists, and the survivors are checked for the
+    whole word. A shorter word matches the start of a word.
+
+    For every sort method the plugins are also kept in sorted order, with
+    each plugin's rank in it, so sorting the results of a query is a sort of
+    integers, or a single pass over the order when most plugins matched. The
+    ranks for a method are only worked out again by the first search that
+    sorts by it after a change.
+
+    update() compares the list with the index and only adds and removes what
+    changed. The list keeps every description at the same address until it
+    is removed, so most are recognised by that without building their
+    identifier. Small additions are inserted into the orders in place, while
+    large ones re-sort them. Removed plugins are left in the trigram lists
+    until they make up a quarter of the index, then it is rebuilt.
+*/
+class PluginIndex
+{
+public:
+	using SortMethod = KnownPluginList::SortMethod;
+	static constexpr int numSortMethods = KnownPluginList::sortByInfoUpdateTime + 1;
+
+	PluginIndex();
+	~PluginIndex();
+
+	//==============================================================================
+	/** Replaces the contents with the list's. */
+	void rebuild(const KnownPluginList& list);
+
+	/** Brings the index in line with the list, touching only what was added or removed. */
+	void update(const KnownPluginList& list);
+
+	//==============================================================================
+	/** Fills results with the IDs of the plugins matching every word of query, an empty query matching all. */
+	void search(const String& query, SortMethod method, bool forwards, std::vector<int>& results) const;
+
+	const PluginDescription& getDescription(int id) const noexcept { return entries[(size_t)id].description; }
+	int getNumPlugins() const noexcept { return numLive; }
+
+private:
+	//==============================================================================
+	struct Entry
+	{
+		PluginDescription description;
+		String key, identity;
+		const PluginDescription* source = nullptr;
+		bool removed = false;
+	};
+
+	void add(const PluginDescription* type);
+	void addGrams(int id);
+	void sortOrders(bool fully);
+	const std::vector<int>& getRanks(int method) const;
+	bool isBefore(SortMethod method, int first, int second) const;
+	static bool isUnchanged(const Entry& entry, const PluginDescription& description) noexcept;
+	const std::vector<int>* findCandidates(const String& word, std::vector<int>& scratch) const;
+
+	std::vector<Entry> entries;
+	std::unordered_map<String, int> idByIdentity;
+	std::unordered_map<const PluginDescription*, int> idBySource;
+	std::unordered_map<uint64, std::vector<int>> postings;
+	std::vector<int> orders[numSortMethods];
+	mutable std::vector<int> ranks[numSortMethods];
+	mutable bool ranksStale[numSortMethods] = {};
+	std::vector<int> pendingInsertions;
+	int numLive = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginIndex)
+};
@@ -14,24 +14,45 @@
 //==============================================================================
 MicroChromoAudioProcessor::MicroChromoAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", AudioChannelSet::stereo(), true)
-                     #endif
-                       ),
-	   parameters(*this, nullptr, Identifier("MicroChromoParam"),
-		   {
-			   std::make_unique<AudioParameterFloat>("gain", "Gain", 0.0f, 1.0f, 0.5f)
-		   })
+     : AudioProcessor (createBusesProperties()),
+	   parameters(*this, nullptr, Identifier("MicroChromoParam"), createParameterLayout())
 #endif
 {
+	proxies.attach(parameters);
+	noteOffsets.insertMultiple(0, 0.0f, 128);
+	history.reset(captureTopology(), noteOffsets, captureGlide());
+	startTimer(pollIntervalMs);
 }
 
 MicroChromoAudioProcessor::~MicroChromoAudioProcessor()
 {
+	// Closing normally leaves nothing to recover.
+	journal.close(false);
+	stopTimer();
+}
+
+AudioProcessor::BusesProperties MicroChromoAudioProcessor::createBusesProperties()
+{
+	BusesProperties buses;
+   #if ! JucePlugin_IsMidiEffect
+    #if ! JucePlugin_IsSynth
+	buses.addBus(true, "Input", AudioChannelSet::stereo(), true);
+    #endif
+	buses.addBus(false, "Output", AudioChannelSet::stereo(), true);
+
+	// Disabled until the host asks for them; see connectAudioNodes().
+	for (int i = 1; i <= maxAuxOutputs; ++i)
+		buses.addBus(false, "Instance " + String(i), AudioChannelSet::stereo(), false);
+   #endif
+	return buses;
+}
+
+AudioProcessorValueTreeState::ParameterLayout MicroChromoAudioProcessor::createParameterLayout()
+{
+	AudioProcessorValueTreeState::ParameterLayout layout;
+	layout.add(std::make_unique<AudioParameterFloat>("gain", "Gain", 0.0f, 1.0f, 0.5f));
+	ParameterProxyPool::addToLayout(layout);
+	return layout;
 }
 
 //==============================================================================
@@ -74,26 +95,39 @@ double MicroChromoAudioProcessor::getTailLengthSeconds() const
 
 int MicroChromoAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return jmax(1, programBank.getNumPrograms());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                                     // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int MicroChromoAudioProcessor::getCurrentProgram()
 {
-    return 0;
+	const auto pending = pendingProgram.load();
+    return pending >= 0 ? pending : currentProgram;
 }
 
 void MicroChromoAudioProcessor::setCurrentProgram (int index)
 {
+	// Some wrappers call this from the audio thread, and a program may need
+	// a new graph, so anywhere else it is only noted for timerCallback().
+	if (!MessageManager::existsAndIsCurrentThread())
+	{
+		pendingProgram = jmax(0, index);
+		return;
+	}
+
+	pendingProgram = -1;
+	if (applyProgram(index))
+		recordEdit("Load Program");
 }
 
 const String MicroChromoAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return programBank.getProgramName(index);
 }
 
 void MicroChromoAudioProcessor::changeProgramName (int index, const String& newName)
 {
+	programBank.setProgramName(index, newName);
 }
 
 //==============================================================================
@@ -101,16 +135,49 @@ void MicroChromoAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-	mainProcessor.setPlayConfigDetails(getMainBusNumInputChannels(), getMainBusNumOutputChannels(), sampleRate, samplesPerBlock);
+	const ScopedLock sl(idleLock);
+	const auto resumeStartTicks = Time::getHighResolutionTicks();
+	const auto resumedFrom = idle.prepare(sampleRate);
+
+	mainProcessor.setPlayConfigDetails(getTotalNumInputChannels(), getTotalNumOutputChannels(), sampleRate, samplesPerBlock);
+	governor.prepare(sampleRate, samplesPerBlock);
+
+	// Loading the instances can take seconds, so a new rate or block size
+	// only prepares the ones there are again. Unloaded ones come back with
+	// the state they were saved with.
+	if (instanceNodes.isEmpty())
+	{
+		initializeGraph();
+		restoreInstanceStates(unloadedStates);
+	}
+	else
+	{
+		reprepareGraph();
+	}
+
+	unloadedStates.clear();
+
+	// Prepared by now, so the graph leaves the instances as they are.
 	mainProcessor.prepareToPlay(sampleRate, samplesPerBlock);
-	initializeGraph();
+
+	// The backends know their latency now, and the host asks for it next.
+	updateLatencyCompensation();
+	idle.setResumeTime(resumedFrom, Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - resumeStartTicks) * 1000.0);
+
+	// Offline renders and the command-line modes have no session to recover.
+	if (autosaveEnabled && !isNonRealtime() && !journal.isOpen())
+		startAutosave();
 }
 
 void MicroChromoAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+	const ScopedLock sl(idleLock);
 	mainProcessor.releaseResources();
+	schedule.releaseScratch();
+	midiPool.release();
+	idle.released();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -132,6 +199,12 @@ bool MicroChromoAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
         return false;
    #endif
 
+	// Instance outputs are either off or stereo.
+	for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+		if (!layouts.outputBuses.getReference(bus).isDisabled()
+			&& layouts.outputBuses.getReference(bus) != AudioChannelSet::stereo())
+			return false;
+
     return true;
   #endif
 }
@@ -152,8 +225,63 @@ void MicroChromoAudioProcessor::processBlock (AudioBuffer<float>& buffer, MidiBu
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+	governor.blockStarted();
 	updateGraph();
-	mainProcessor.processBlock(buffer, midiMessages);
+	proxies.forward(backends.getRawDataPointer(), backends.size());
+	applyLoadLevel();
+	midiRouter.process(midiMessages, buffer.getNumSamples());
+
+	// Long idle, nothing reaches the instances; the graph only passes the
+	// MIDI through, so neither skipping nor the schedule touch it.
+	if (idle.shouldSkip(isBlockIdle(), buffer.getNumSamples()))
+	{
+		for (auto i = 0; i < totalNumOutputChannels; ++i)
+			buffer.clear(i, 0, buffer.getNumSamples());
+	}
+	else if (!topologyFrozen.load() || !schedule.render(buffer))
+	{
+		mainProcessor.processBlock(buffer, midiMessages);
+	}
+
+	governor.blockFinished(buffer.getNumSamples());
+	recorder.push(0, buffer, buffer.getNumSamples());
+
+	// Only flagged here; the timer lines the instances up again.
+	for (auto& node : instanceNodes)
+		if (static_cast<InstanceProcessor*>(node->getProcessor())->checkLatencyChanged())
+			latencyChanged = true;
+
+	// In MPE mode the rewritten stream also goes to the MIDI output, so the
+	// host can drive an external MPE synth with it.
+	if (midiRouter.getOutputMode() == MidiRouter::OutputMode::mpe)
+	{
+		// Rendered into a buffer sized for the whole pool and swapped in,
+		// rather than copied into the host's, which might have to grow.
+		midiOutput.clear();
+		midiPool.renderView(0, midiOutput);
+		midiMessages.swapWith(midiOutput);
+	}
+}
+
+void MicroChromoAudioProcessor::processBlockBypassed(AudioBuffer<float>& buffer, MidiBuffer&)
+{
+	// The instances are not rendered while bypassed, which counts as idle.
+	idle.shouldSkip(true, buffer.getNumSamples());
+
+	for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+		buffer.clear(i, 0, buffer.getNumSamples());
+}
+
+bool MicroChromoAudioProcessor::isBlockIdle() const noexcept
+{
+	if (midiPool.getNumEvents() > 0 || midiRouter.getNumSoundingNotes() > 0)
+		return false;
+
+	for (auto& node : instanceNodes)
+		if (!static_cast<InstanceProcessor*>(node->getProcessor())->isOutputSilent())
+			return false;
+
+	return true;
 }
 
 //==============================================================================
@@ -174,6 +302,27 @@ void MicroChromoAudioProcessor::getStateInformation (MemoryBlock& destData)
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
 	auto state = parameters.copyState();
+	state.appendChild(programBank.toValueTree(), nullptr);
+	state.appendChild(proxies.toValueTree(), nullptr);
+	state.setProperty("currentProgram", currentProgram, nullptr);
+	state.appendChild(captureTopology().toValueTree(), nullptr);
+	state.appendChild(captureGlide().toValueTree(), nullptr);
+
+	StringArray tuning;
+	for (auto cents : noteOffsets)
+		tuning.add(String(cents));
+	state.setProperty("tuning", tuning.joinIntoString(" "), nullptr);
+
+	// Unloaded instances are saved with the state they went away with.
+	const auto instanceStates = instanceNodes.isEmpty() ? unloadedStates : captureNodeStates();
+	ValueTree instances("Instances");
+	for (auto& instanceState : instanceStates)
+		instances.appendChild(ValueTree("Instance").setProperty("state", instanceState.toBase64Encoding(), nullptr), nullptr);
+	state.appendChild(instances, nullptr);
+
+	// Tells a later session whether the journal holds anything newer.
+	state.setProperty("autosaveId", autosaveId, nullptr);
+	state.setProperty("autosaveGeneration", journal.getGeneration(), nullptr);
 	std::unique_ptr<XmlElement> xml(state.createXml());
 	copyXmlToBinary(*xml, destData);
 }
@@ -186,31 +335,181 @@ void MicroChromoAudioProcessor::setStateInformation (const void* data, int sizeI
 
 	if (xmlState.get() != nullptr)
 		if (xmlState->hasTagName(parameters.state.getType()))
-			parameters.replaceState(ValueTree::fromXml(*xmlState));
+		{
+			auto state = ValueTree::fromXml(*xmlState);
+			auto bank = state.getChildWithName(ProgramBank::bankType);
+			state.removeChild(bank, nullptr);
+			auto mappings = state.getChildWithName(ParameterProxyPool::mappingsType);
+			state.removeChild(mappings, nullptr);
+			currentProgram = state.getProperty("currentProgram", 0);
+			state.removeProperty("currentProgram", nullptr);
+			auto topology = state.getChildWithName("Topology");
+			state.removeChild(topology, nullptr);
+			auto glide = state.getChildWithName("Glide");
+			state.removeChild(glide, nullptr);
+			auto instances = state.getChildWithName("Instances");
+			state.removeChild(instances, nullptr);
+			auto tuning = StringArray::fromTokens(state.getProperty("tuning").toString(), false);
+			tuning.removeEmptyStrings();
+			state.removeProperty("tuning", nullptr);
+			const auto savedAutosaveId = state.getProperty("autosaveId").toString();
+			const auto savedAutosaveGeneration = (int64)state.getProperty("autosaveGeneration", 0);
+			state.removeProperty("autosaveId", nullptr);
+			state.removeProperty("autosaveGeneration", nullptr);
+
+			// The selected program first, then whatever was changed after
+			// loading it, as saved along with it.
+			programBank.fromValueTree(bank);
+			applyProgram(currentProgram);
+			parameters.replaceState(state);
+			proxies.fromValueTree(mappings);
+
+			// States saved before these were stored keep the current settings.
+			auto offsets = std::make_shared<Array<float>>(noteOffsets);
+			for (int i = 0; i < jmin(128, tuning.size()); ++i)
+				offsets->set(i, tuning[i].getFloatValue());
+
+			GraphHistory::Snapshot snapshot;
+			snapshot.topology = std::make_shared<const GraphHistory::Topology>(topology.isValid() ? GraphHistory::Topology::fromValueTree(topology) : captureTopology());
+			snapshot.glide = std::make_shared<const GraphHistory::Glide>(glide.isValid() ? GraphHistory::Glide::fromValueTree(glide) : captureGlide());
+			snapshot.tuning = offsets;
+			restoreSnapshot(snapshot);
+
+			Array<MemoryBlock> instanceStates;
+			for (const auto& instance : instances)
+			{
+				MemoryBlock instanceState;
+				instanceState.fromBase64Encoding(instance["state"].toString());
+				instanceStates.add(instanceState);
+			}
+			// A different session's instances, if unloaded, are not coming back.
+			unloadedStates.clear();
+			restoreInstanceStates(instanceStates);
+
+			history.reset(captureTopology(), noteOffsets, captureGlide());
+			recoverAutosave(savedAutosaveId, savedAutosaveGeneration);
+		}
 }
 
 void MicroChromoAudioProcessor::initializeGraph()
 {
+	schedule.clear();
 	mainProcessor.clear();
+	instanceNodes.clear();
+	backends.clearQuick();
+
+	audioInputNode = mainProcessor.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::audioInputNode));
+	audioOutputNode = mainProcessor.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::audioOutputNode));
+	midiInputNode = mainProcessor.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::midiInputNode));
+	midiOutputNode = mainProcessor.addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor::midiOutputNode));
+
+	// A single MPE-capable instance replaces the clones.
+	const auto numNodes = midiRouter.getOutputMode() == MidiRouter::OutputMode::mpe ? 1 : numInstances;
+
+	prepareMidiPool(numNodes);
+	midiRouter.prepare(numNodes, getSampleRate(), getBlockSize());
+	midiRouter.setNoteOffsets(noteOffsets);
+	midiRouter.setBendTuningEnabled(usesPitchBendTuning());
+
+	for (int i = 0; i < numNodes; ++i)
+	{
+		auto backend = createBackend();
+		if (backend == nullptr)
+			break;
+
+		if (auto* synth = dynamic_cast<ReferenceSynth*>(backend.get()))
+			if (!usesPitchBendTuning())
+				synth->setNoteOffsets(noteOffsets);
+
+		auto instance = std::make_unique<InstanceProcessor>(std::move(backend), midiPool, i);
+		instance->setRecorder(&recorder);
+		backends.add(instance->getBackend());
+		instanceNodes.add(mainProcessor.addNode(std::move(instance)));
+	}
+
+	// Fresh instances start from their defaults, so they need every mapped value.
+	proxies.invalidate();
+	appliedLoadLevel = -1;
+
+	connectAudioNodes();
+	connectMidiNodes();
+	prepareInstances();
+}
+
+void MicroChromoAudioProcessor::prepareMidiPool(int numNodes)
+{
+	midiPool.prepare(numNodes, getBlockSize());
+
+	// A MidiBuffer keeps a 6-byte header with every event's data.
+	midiOutput.ensureSize((size_t)midiPool.getByteCapacity() + 6 * (size_t)midiPool.getEventCapacity());
+}
 
-	//audioInputNode = mainProcessor->addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor(AudioGraphIOProcessor::audioInputNode)));
-	//audioOutputNode = mainProcessor->addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor(AudioGraphIOProcessor::audioOutputNode)));
-	//midiInputNode = mainProcessor->addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor(AudioGraphIOProcessor::midiInputNode)));
-	//midiOutputNode = mainProcessor->addNode(std::make_unique<AudioGraphIOProcessor>(AudioGraphIOProcessor(AudioGraphIOProcessor::midiOutputNode)));
+void MicroChromoAudioProcessor::reprepareGraph()
+{
+	const auto numNodes = instanceNodes.size();
+
+	prepareMidiPool(numNodes);
+	midiRouter.prepare(numNodes, getSampleRate(), getBlockSize());
+	midiRouter.setNoteOffsets(noteOffsets);
+	midiRouter.setBendTuningEnabled(usesPitchBendTuning());
+	appliedLoadLevel = -1;
+
+	prepareInstances();
 
-	//connectAudioNodes();
-	//connectMidiNodes();
+	// The connections only depend on which outputs are enabled.
+	if (getBusesLayout() != connectedLayout)
+	{
+		schedule.clear();
+		for (auto& connection : mainProcessor.getConnections())
+			mainProcessor.removeConnection(connection);
+
+		connectAudioNodes();
+		connectMidiNodes();
+	}
+	else
+	{
+		schedule.compile(getTotalNumOutputChannels(), getBlockSize());
+	}
 }
 
 void MicroChromoAudioProcessor::connectAudioNodes()
 {
-	for (int channel = 0; channel < 2; ++channel)
-		mainProcessor.addConnection({ { audioInputNode->nodeID,  channel },
-										{ audioOutputNode->nodeID, channel } });
+	// With instance outputs enabled, the instances are split into as many
+	// groups as there are enabled buses, one per bus when there are enough,
+	// and each group goes only to its own bus. Every bus channel then has a
+	// single source, so the graph hands the node's buffer straight to the
+	// host instead of mixing it into the main output.
+	connectedLayout = getBusesLayout();
+
+	Array<int> auxBuses;
+	for (int bus = 1; bus < getBusCount(false); ++bus)
+		if (getBus(false, bus)->isEnabled())
+			auxBuses.add(bus);
+
+	const auto numNodes = instanceNodes.size();
+	const auto groupSize = auxBuses.isEmpty() ? numNodes : (numNodes + auxBuses.size() - 1) / auxBuses.size();
+
+	for (int i = 0; i < numNodes; ++i)
+	{
+		const auto bus = auxBuses.isEmpty() ? 0 : auxBuses[i / jmax(1, groupSize)];
+		const auto step = schedule.addInstance(static_cast<InstanceProcessor*>(instanceNodes[i]->getProcessor()));
+
+		for (int channel = 0; channel < jmin(2, getBus(false, bus)->getNumberOfChannels()); ++channel)
+		{
+			const auto outputChannel = getChannelIndexInProcessBlockBuffer(false, bus, channel);
+			mainProcessor.addConnection({ { instanceNodes[i]->nodeID,  channel },
+											{ audioOutputNode->nodeID, outputChannel } });
+			schedule.addRoute(step, channel, outputChannel);
+		}
+	}
+
+	// The same routing, flattened for processBlock() to use instead of the graph.
+	schedule.compile(getTotalNumOutputChannels(), getBlockSize());
 }
 
 void MicroChromoAudioProcessor::connectMidiNodes()
 {
+	// Instances read their MIDI from midiPool, only the pass-through is wired.
 	mainProcessor.addConnection({ { midiInputNode->nodeID,  AudioProcessorGraph::midiChannelIndex },
 									{ midiOutputNode->nodeID, AudioProcessorGraph::midiChannelIndex } });
 }
@@ -219,6 +518,712 @@ void MicroChromoAudioProcessor::updateGraph()
 {
 }
 
+void MicroChromoAudioProcessor::timerCallback()
+{
+	if (latencyChanged.exchange(false))
+		updateLatencyCompensation();
+
+	const auto program = pendingProgram.exchange(-1);
+	if (program >= 0 && applyProgram(program))
+		recordEdit("Load Program");
+}
+
+void MicroChromoAudioProcessor::updateLatencyCompensation()
+{
+	// Delay every instance to match the slowest one, then report that to the
+	// host together with the lookahead the router holds MIDI back by.
+	int maxLatency = 0;
+	for (auto& node : instanceNodes)
+		maxLatency = jmax(maxLatency, static_cast<InstanceProcessor*>(node->getProcessor())->getBackendLatency());
+
+	for (auto& node : instanceNodes)
+	{
+		auto* instance = static_cast<InstanceProcessor*>(node->getProcessor());
+		instance->setCompensationDelay(maxLatency - instance->getBackendLatency());
+	}
+
+	const auto totalLatency = maxLatency + midiRouter.getLookahead();
+	if (totalLatency != getLatencySamples())
+		setLatencySamples(totalLatency);
+}
+
+void MicroChromoAudioProcessor::rebuildGraph()
+{
+	// Keep the outgoing instances' state with the current step, so undoing
+	// back to it brings them back as they were.
+	if (!instanceNodes.isEmpty())
+		history.refreshNodeStates(captureNodeStates());
+
+	suspendProcessing(true);
+	initializeGraph();
+	suspendProcessing(false);
+
+	// An edit while released replaces any unloaded instances, and the new
+	// ones wait for prepareToPlay() like the others would have.
+	unloadedStates.clear();
+	if (idle.isReleased())
+		idle.released();
+}
+
+void MicroChromoAudioProcessor::reprepareRouter()
+{
+	// Before the first prepareToPlay(), or while unloaded, the router is
+	// prepared along with the instances.
+	if (instanceNodes.isEmpty())
+		return;
+
+	// Only the router holds what changed, so the instances stay loaded and
+	// just let go of the notes the router forgets.
+	suspendProcessing(true);
+	midiRouter.prepare(instanceNodes.size(), getSampleRate(), getBlockSize());
+	midiRouter.setBendTuningEnabled(usesPitchBendTuning());
+	applyNoteOffsets();
+
+	for (auto& node : instanceNodes)
+		node->getProcessor()->reset();
+	suspendProcessing(false);
+}
+
+void MicroChromoAudioProcessor::unloadInstances()
+{
+	const ScopedLock sl(idleLock);
+	if (idle.getTier() != IdlePolicy::trimmed || instanceNodes.isEmpty())
+		return;
+
+	// Released long enough to let go of the backends too.
+	unloadedStates = captureNodeStates();
+
+	suspendProcessing(true);
+	schedule.clear();
+	mainProcessor.clear();
+	instanceNodes.clear();
+	backends.clearQuick();
+	suspendProcessing(false);
+
+	idle.setUnloaded();
+}
+
+void MicroChromoAudioProcessor::prepareInstances()
+{
+	const auto sampleRate = getSampleRate();
+	const auto blockSize = getBlockSize();
+	if (sampleRate <= 0.0 || blockSize <= 0 || instanceNodes.isEmpty() || idle.isReleased())
+		return;
+
+	auto prepare = [sampleRate, blockSize](InstanceProcessor* instance)
+	{
+		instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+		instance->prepareToPlay(sampleRate, blockSize);
+	};
+
+	// Sandboxed backends prepare in their own processes and the reference
+	// synth is ours, so those clones are prepared side by side. Plugins
+	// loaded in process may not expect to be prepared off the message
+	// thread, or several at once, so they get their turn here.
+	auto* backend = getInstanceProcessor(0)->getBackend();
+	const auto inParallel = instanceNodes.size() > 1
+		&& (dynamic_cast<SandboxedProcessor*>(backend) != nullptr || dynamic_cast<ReferenceSynth*>(backend) != nullptr);
+
+	if (!inParallel)
+	{
+		for (int i = 0; i < instanceNodes.size(); ++i)
+			prepare(getInstanceProcessor(i));
+		return;
+	}
+
+	WaitableEvent finished;
+	std::atomic<int> remaining{ instanceNodes.size() };
+
+	for (int i = 0; i < instanceNodes.size(); ++i)
+	{
+		auto* instance = getInstanceProcessor(i);
+		preparers->pool.addJob([&, instance]
+		{
+			prepare(instance);
+			if (--remaining == 0)
+				finished.signal();
+		});
+	}
+
+	finished.wait();
+}
+
+std::unique_ptr<AudioProcessor> MicroChromoAudioProcessor::createBackend()
+{
+	if (backendDescription == nullptr)
+		return std::make_unique<ReferenceSynth>();
+
+	if (sandboxEnabled)
+		return std::make_unique<SandboxedProcessor>(*backendDescription, SandboxedProcessor::getDefaultBridgeExecutable());
+
+	String errorMessage;
+	auto instance = pluginDatabase->getFormatManager().createPluginInstance(*backendDescription, getSampleRate(), getBlockSize(), errorMessage);
+
+	if (instance == nullptr)
+		DBG("Failed to create backend: " + errorMessage);
+
+	return instance;
+}
+
+//==============================================================================
+void MicroChromoAudioProcessor::setNumInstances(int newNumInstances)
+{
+	newNumInstances = jlimit(1, 64, newNumInstances);
+	if (newNumInstances != numInstances)
+	{
+		numInstances = newNumInstances;
+		rebuildGraph();
+		recordEdit("Change Instance Count");
+	}
+}
+
+bool MicroChromoAudioProcessor::startRecording(const File& mixFile, bool includeInstances)
+{
+	return recorder.start(mixFile, getSampleRate(), getMainBusNumOutputChannels(), includeInstances ? instanceNodes.size() : 0);
+}
+
+void MicroChromoAudioProcessor::stopRecording()
+{
+	recorder.stop();
+}
+
+InstanceProcessor* MicroChromoAudioProcessor::getInstanceProcessor(int index) const
+{
+	auto node = instanceNodes[index];
+	return node != nullptr ? static_cast<InstanceProcessor*>(node->getProcessor()) : nullptr;
+}
+
+void MicroChromoAudioProcessor::clearIsolation()
+{
+	for (auto& node : instanceNodes)
+		static_cast<InstanceProcessor*>(node->getProcessor())->clearIsolation();
+}
+
+bool MicroChromoAudioProcessor::mapParameter(int slot, int backendParameterIndex)
+{
+	if (backends.isEmpty())
+		return false;
+
+	// The clones share a plugin, so the first one stands for all of them.
+	if (!proxies.map(slot, backendParameterIndex, *backends.getFirst()))
+		return false;
+
+	// The slot's name and value have changed, which the host only rereads when told.
+	updateHostDisplay();
+	return true;
+}
+
+void MicroChromoAudioProcessor::unmapParameter(int slot)
+{
+	proxies.unmap(slot);
+	updateHostDisplay();
+}
+
+void MicroChromoAudioProcessor::setBackend(const PluginDescription& description)
+{
+	backendDescription.reset(new PluginDescription(description));
+	proxies.unmapAll();
+	rebuildGraph();
+	updateHostDisplay();
+	recordEdit("Change Backend");
+}
+
+void MicroChromoAudioProcessor::useReferenceBackend()
+{
+	backendDescription = nullptr;
+	proxies.unmapAll();
+	rebuildGraph();
+	updateHostDisplay();
+	recordEdit("Use Reference Synth");
+}
+
+void MicroChromoAudioProcessor::setSandboxEnabled(bool shouldRunOutOfProcess)
+{
+	if (shouldRunOutOfProcess != sandboxEnabled)
+	{
+		sandboxEnabled = shouldRunOutOfProcess;
+		if (backendDescription != nullptr)
+			rebuildGraph();
+		recordEdit("Toggle Sandbox");
+	}
+}
+
+bool MicroChromoAudioProcessor::usesPitchBendTuning() const noexcept
+{
+	// Without a hosted backend, the built-in reference synth renders the notes
+	// at their exact frequency, so the router need not insert pitch bends
+	// unless MPE output or adaptive tuning, which retunes held notes, was
+	// asked for explicitly.
+	return backendDescription != nullptr || midiRouter.getOutputMode() == MidiRouter::OutputMode::mpe || adaptiveTuning;
+}
+
+void MicroChromoAudioProcessor::setOutputMode(MidiRouter::OutputMode newMode)
+{
+	if (newMode != midiRouter.getOutputMode())
+	{
+		midiRouter.setOutputMode(newMode);
+		rebuildGraph();
+		recordEdit("Change Output Mode");
+	}
+}
+
+void MicroChromoAudioProcessor::setMpeZone(bool useLowerZone, int numMemberChannels, int perNotePitchbendRange)
+{
+	mpeLowerZone = useLowerZone;
+	mpeNumMemberChannels = numMemberChannels;
+	mpePitchbendRange = perNotePitchbendRange;
+	midiRouter.setMpeZone(useLowerZone, numMemberChannels, perNotePitchbendRange);
+
+	// The router sends the new zone layout on the next block.
+	if (midiRouter.getOutputMode() == MidiRouter::OutputMode::mpe)
+		reprepareRouter();
+	recordEdit("Change MPE Zone");
+}
+
+void MicroChromoAudioProcessor::setLookahead(int samples)
+{
+	samples = jlimit(0, maxLookaheadSamples, samples);
+	if (samples != midiRouter.getLookahead())
+	{
+		midiRouter.setLookahead(samples);
+		reprepareRouter();
+		updateLatencyCompensation();
+		recordEdit("Change Lookahead");
+	}
+}
+
+void MicroChromoAudioProcessor::setGlide(float retuneMs, float portamentoMs, GlideEngine::Shape shape)
+{
+	retuneGlideMs = retuneMs;
+	portamentoGlideMs = portamentoMs;
+	glideShape = shape;
+	midiRouter.setGlide(retuneMs, portamentoMs, shape);
+	recordEdit("Change Glide");
+}
+
+void MicroChromoAudioProcessor::setAdaptiveTuning(bool shouldAdapt, float driftLimitCents)
+{
+	const auto usedPitchBends = usesPitchBendTuning();
+	adaptiveTuning = shouldAdapt;
+	adaptiveDriftCents = jmax(0.0f, driftLimitCents);
+	midiRouter.setAdaptiveTuning(adaptiveTuning, adaptiveDriftCents);
+
+	// The reference synth has to go from per-note frequencies to following bends.
+	if (usesPitchBendTuning() != usedPitchBends)
+		reprepareRouter();
+
+	recordEdit("Change Adaptive Tuning");
+}
+
+void MicroChromoAudioProcessor::setNoteOffsets(const Array<float>& centsPerNote)
+{
+	for (int i = 0; i < 128; ++i)
+		noteOffsets.set(i, centsPerNote[i]);
+
+	applyNoteOffsets();
+	recordEdit("Change Tuning");
+}
+
+Array<float> MicroChromoAudioProcessor::loadTuningFile(const File& file)
+{
+	auto tokens = StringArray::fromTokens(file.loadFileAsString(), false);
+	tokens.removeEmptyStrings();
+
+	Array<float> centsPerNote;
+	for (int i = 0; i < 128; ++i)
+		centsPerNote.add(tokens[i].getFloatValue());
+	return centsPerNote;
+}
+
+void MicroChromoAudioProcessor::applyNoteOffsets()
+{
+	midiRouter.setNoteOffsets(noteOffsets);
+
+	// Following the router's bends, the reference synth plays the notes untuned.
+	const auto synthOffsets = usesPitchBendTuning() ? Array<float>() : noteOffsets;
+
+	for (auto& node : instanceNodes)
+		if (auto* instance = dynamic_cast<InstanceProcessor*>(node->getProcessor()))
+			if (auto* synth = dynamic_cast<ReferenceSynth*>(instance->getBackend()))
+				synth->setNoteOffsets(synthOffsets);
+}
+
+//==============================================================================
+void MicroChromoAudioProcessor::recordEdit(const String& name)
+{
+	history.commit(name, captureTopology(), noteOffsets, captureGlide());
+}
+
+GraphHistory::Topology MicroChromoAudioProcessor::captureTopology() const
+{
+	GraphHistory::Topology topology;
+	topology.numInstances = numInstances;
+	topology.outputMode = midiRouter.getOutputMode();
+	topology.mpeLowerZone = mpeLowerZone;
+	topology.mpeNumMemberChannels = mpeNumMemberChannels;
+	topology.mpePitchbendRange = mpePitchbendRange;
+	topology.lookaheadSamples = midiRouter.getLookahead();
+	topology.sandboxed = sandboxEnabled;
+	topology.adaptiveTuning = adaptiveTuning;
+	topology.adaptiveDriftCents = adaptiveDriftCents;
+
+	if (backendDescription != nullptr)
+		topology.backend.reset(new PluginDescription(*backendDescription));
+
+	return topology;
+}
+
+GraphHistory::Glide MicroChromoAudioProcessor::captureGlide() const
+{
+	return { retuneGlideMs, portamentoGlideMs, glideShape };
+}
+
+Array<MemoryBlock> MicroChromoAudioProcessor::captureNodeStates()
+{
+	Array<MemoryBlock> states;
+	for (auto& node : instanceNodes)
+	{
+		MemoryBlock state;
+		static_cast<InstanceProcessor*>(node->getProcessor())->getBackend()->getStateInformation(state);
+		states.add(state);
+	}
+	return states;
+}
+
+void MicroChromoAudioProcessor::restoreInstanceStates(const Array<MemoryBlock>& states)
+{
+	// Empty entries leave their instance as it is.
+	for (int i = 0; i < states.size(); ++i)
+	{
+		const auto& state = states.getReference(i);
+		if (state.getSize() == 0)
+			continue;
+
+		// Before the first prepareToPlay(), or while unloaded, there are no
+		// instances yet; prepareToPlay() hands the states to the new ones.
+		if (instanceNodes.isEmpty())
+		{
+			while (unloadedStates.size() <= i)
+				unloadedStates.add({});
+			unloadedStates.set(i, state);
+		}
+		else if (i < instanceNodes.size())
+		{
+			getInstanceProcessor(i)->getBackend()->setStateInformation(state.getData(), (int)state.getSize());
+		}
+	}
+}
+
+void MicroChromoAudioProcessor::restoreSnapshot(const GraphHistory::Snapshot& snapshot)
+{
+	const auto& topology = *snapshot.topology;
+	const auto previous = captureTopology();
+	const auto needsRebuild = !topology.hasSameInstances(previous);
+
+	numInstances = topology.numInstances;
+	sandboxEnabled = topology.sandboxed;
+	backendDescription.reset(topology.backend != nullptr ? new PluginDescription(*topology.backend) : nullptr);
+	mpeLowerZone = topology.mpeLowerZone;
+	mpeNumMemberChannels = topology.mpeNumMemberChannels;
+	mpePitchbendRange = topology.mpePitchbendRange;
+	midiRouter.setMpeZone(mpeLowerZone, mpeNumMemberChannels, mpePitchbendRange);
+	midiRouter.setOutputMode(topology.outputMode);
+	midiRouter.setLookahead(topology.lookaheadSamples);
+	adaptiveTuning = topology.adaptiveTuning;
+	adaptiveDriftCents = topology.adaptiveDriftCents;
+	midiRouter.setAdaptiveTuning(adaptiveTuning, adaptiveDriftCents);
+
+	retuneGlideMs = snapshot.glide->retuneMs;
+	portamentoGlideMs = snapshot.glide->portamentoMs;
+	glideShape = snapshot.glide->shape;
+	midiRouter.setGlide(retuneGlideMs, portamentoGlideMs, glideShape);
+
+	for (int i = 0; i < 128; ++i)
+		noteOffsets.set(i, (*snapshot.tuning)[i]);
+
+	if (needsRebuild)
+	{
+		rebuildGraph();
+		updateLatencyCompensation();
+
+		// Fresh instances get the state they had when the step was left.
+		if (snapshot.nodeStates != nullptr)
+			for (int i = 0; i < jmin(instanceNodes.size(), snapshot.nodeStates->size()); ++i)
+				if (auto blob = (*snapshot.nodeStates)[i])
+					static_cast<InstanceProcessor*>(instanceNodes[i]->getProcessor())->getBackend()
+						->setStateInformation(blob->getData(), (int)blob->getSize());
+	}
+	else if (topology != previous)
+	{
+		reprepareRouter();
+		updateLatencyCompensation();
+	}
+
+	applyNoteOffsets();
+}
+
+//==============================================================================
+void MicroChromoAudioProcessor::setAutosaveEnabled(bool shouldAutosave)
+{
+	autosaveEnabled = shouldAutosave;
+
+	// Closing normally leaves nothing to recover.
+	if (!autosaveEnabled)
+		journal.close(false);
+}
+
+void MicroChromoAudioProcessor::startAutosave()
+{
+	if (autosaveId.isEmpty())
+		autosaveId = Uuid().toString();
+
+	if (!journal.open(AutosaveJournal::getDefaultDirectory().getChildFile(autosaveId + ".journal")))
+	{
+		autosaveId = Uuid().toString();
+		journal.open(AutosaveJournal::getDefaultDirectory().getChildFile(autosaveId + ".journal"));
+	}
+}
+
+void MicroChromoAudioProcessor::captureAutosave()
+{
+	auto toBlock = [](const ValueTree& tree)
+	{
+		MemoryOutputStream out;
+		tree.writeToStream(out);
+		return out.getMemoryBlock();
+	};
+
+	Array<float> values;
+	for (auto* param : getParameters())
+		values.add(param->getValue());
+	journal.writeValues(values);
+
+	journal.writeSection("topology", toBlock(captureTopology().toValueTree()));
+	journal.writeSection("glide", toBlock(captureGlide().toValueTree()));
+	journal.writeSection("tuning", MemoryBlock(noteOffsets.begin(), sizeof(float) * (size_t)noteOffsets.size()));
+	journal.writeSection("programs", toBlock(programBank.toValueTree()));
+	journal.writeSection("proxies", toBlock(proxies.toValueTree()));
+
+	// Backend state can be slow to get, so one instance is saved per snapshot.
+	if (!instanceNodes.isEmpty())
+	{
+		autosaveInstance = (autosaveInstance + 1) % instanceNodes.size();
+		auto* backend = getInstanceProcessor(autosaveInstance)->getBackend();
+
+		// A sandboxed backend's state comes over the pipe, so this saves the
+		// answer to the last request and asks again for the next round.
+		MemoryBlock state;
+		if (auto* sandboxed = dynamic_cast<SandboxedProcessor*>(backend))
+		{
+			state = sandboxed->getLastReceivedState();
+			sandboxed->requestState();
+		}
+		else
+		{
+			backend->getStateInformation(state);
+		}
+
+		if (state.getSize() > 0)
+			journal.writeSection("instance" + String(autosaveInstance), state);
+	}
+
+	journal.commit();
+}
+
+void MicroChromoAudioProcessor::recoverAutosave(const String& savedId, int64 savedGeneration)
+{
+	// Only a session that never closed, having crashed, leaves its journal behind.
+	const auto file = AutosaveJournal::getDefaultDirectory().getChildFile(savedId + ".journal");
+	if (!autosaveEnabled || savedId.isEmpty() || savedId == autosaveId || !file.existsAsFile())
+		return;
+
+	journal.close(false);
+	autosaveId = savedId;
+
+	// Another instance restored from the same state, e.g. a duplicate, may already own it.
+	if (!journal.open(file))
+	{
+		autosaveId = {};
+		startAutosave();
+		return;
+	}
+
+	if (journal.getRecovered().generation > savedGeneration)
+		applyRecoveredState(journal.getRecovered());
+
+	journal.clearRecovered();
+}
+
+void MicroChromoAudioProcessor::applyRecoveredState(const AutosaveJournal::Contents& recovered)
+{
+	auto findSection = [&recovered](const String& name) -> const MemoryBlock*
+	{
+		const auto section = recovered.sections.find(name);
+		return section != recovered.sections.end() ? &section->second : nullptr;
+	};
+
+	auto readTree = [&findSection](const String& name)
+	{
+		const auto* section = findSection(name);
+		return section != nullptr ? ValueTree::readFromData(section->getData(), section->getSize()) : ValueTree();
+	};
+
+	const auto& params = getParameters();
+	for (auto& value : recovered.values)
+		if (auto* param = params[value.first])
+			param->setValueNotifyingHost(value.second);
+
+	auto bank = readTree("programs");
+	if (bank.isValid())
+		programBank.fromValueTree(bank);
+
+	auto mappings = readTree("proxies");
+	if (mappings.isValid())
+		proxies.fromValueTree(mappings);
+
+	auto topology = readTree("topology");
+	auto glide = readTree("glide");
+	auto tuning = std::make_shared<Array<float>>(noteOffsets);
+
+	if (const auto* section = findSection("tuning"))
+		if (section->getSize() == sizeof(float) * 128)
+			*tuning = Array<float>(static_cast<const float*>(section->getData()), 128);
+
+	GraphHistory::Snapshot snapshot;
+	snapshot.topology = std::make_shared<const GraphHistory::Topology>(topology.isValid() ? GraphHistory::Topology::fromValueTree(topology) : captureTopology());
+	snapshot.glide = std::make_shared<const GraphHistory::Glide>(glide.isValid() ? GraphHistory::Glide::fromValueTree(glide) : captureGlide());
+	snapshot.tuning = tuning;
+	restoreSnapshot(snapshot);
+
+	// Whether or not the graph was rebuilt, the journal has the newer states.
+	// Instances that do not exist yet get them when prepareToPlay() creates
+	// them, and preparing again keeps the ones that do.
+	Array<MemoryBlock> instanceStates;
+	for (const auto& section : recovered.sections)
+	{
+		if (!section.first.startsWith("instance"))
+			continue;
+
+		const auto index = section.first.substring(8).getIntValue();
+		if (!isPositiveAndBelow(index, 64))
+			continue;
+
+		while (instanceStates.size() <= index)
+			instanceStates.add({});
+		instanceStates.set(index, section.second);
+	}
+	restoreInstanceStates(instanceStates);
+
+	history.reset(captureTopology(), noteOffsets, captureGlide());
+}
+
+int MicroChromoAudioProcessor::storeProgram(const String& name)
+{
+	return programBank.addProgram(name, ProgramBank::encode(captureSettings(), parameters.copyState()));
+}
+
+ProgramSnapshot MicroChromoAudioProcessor::captureSettings() const
+{
+	ProgramSnapshot settings;
+	settings.noteOffsets = noteOffsets;
+	settings.numInstances = numInstances;
+	settings.outputMode = midiRouter.getOutputMode();
+	settings.mpeLowerZone = mpeLowerZone;
+	settings.mpeNumMemberChannels = mpeNumMemberChannels;
+	settings.mpePitchbendRange = mpePitchbendRange;
+	settings.retuneMs = retuneGlideMs;
+	settings.portamentoMs = portamentoGlideMs;
+	settings.glideShape = glideShape;
+	settings.sandboxed = sandboxEnabled;
+
+	if (backendDescription != nullptr)
+		settings.backend.reset(new PluginDescription(*backendDescription));
+
+	return settings;
+}
+
+void MicroChromoAudioProcessor::applyProgramStructure(const ProgramSnapshot& snapshot)
+{
+	numInstances = snapshot.numInstances;
+	sandboxEnabled = snapshot.sandboxed;
+	backendDescription.reset(snapshot.backend != nullptr ? new PluginDescription(*snapshot.backend) : nullptr);
+
+	mpeLowerZone = snapshot.mpeLowerZone;
+	mpeNumMemberChannels = snapshot.mpeNumMemberChannels;
+	mpePitchbendRange = snapshot.mpePitchbendRange;
+	midiRouter.setMpeZone(mpeLowerZone, mpeNumMemberChannels, mpePitchbendRange);
+	midiRouter.setOutputMode(snapshot.outputMode);
+
+	rebuildGraph();
+}
+
+bool MicroChromoAudioProcessor::applyProgram(int index)
+{
+	auto snapshot = programBank.getSnapshot(index);
+	if (snapshot == nullptr)
+		return false;
+
+	currentProgram = index;
+
+	// Only a different backend or voice layout needs a new graph; the rest
+	// is published to the router and the synths, which take it up at the
+	// start of their next block without waiting on this thread.
+	const auto sameStructure = snapshot->hasSameStructure(captureSettings());
+	if (!sameStructure)
+		applyProgramStructure(*snapshot);
+
+	for (int i = 0; i < 128; ++i)
+		noteOffsets.set(i, snapshot->noteOffsets[i]);
+
+	retuneGlideMs = snapshot->retuneMs;
+	portamentoGlideMs = snapshot->portamentoMs;
+	glideShape = snapshot->glideShape;
+
+	// The crossfade glides the sounding notes over to the new tuning; a
+	// new graph has none to move.
+	const auto crossfadeMs = programCrossfadeMs.load();
+	if (sameStructure && crossfadeMs > 0.0f)
+		midiRouter.setNextRetuneGlide(crossfadeMs);
+
+	midiRouter.setGlide(retuneGlideMs, portamentoGlideMs, glideShape);
+	applyNoteOffsets();
+
+	const auto& params = getParameters();
+	for (const auto& value : snapshot->parameterValues)
+		if (auto* param = params[value.index])
+			param->setValueNotifyingHost(value.normalisedValue);
+
+	return true;
+}
+
+void MicroChromoAudioProcessor::applyLoadLevel() noexcept
+{
+	// Offline there is no deadline, so nothing is given up.
+	const auto level = isNonRealtime() ? LoadGovernor::normal : governor.getLevel();
+
+	if (level != appliedLoadLevel)
+	{
+		midiRouter.setCoarseGlides(level >= LoadGovernor::coarseGlides);
+
+		for (auto& node : instanceNodes)
+			static_cast<InstanceProcessor*>(node->getProcessor())->setSleepAllowed(level >= LoadGovernor::sleepIdleInstances);
+
+		// Stolen notes stay released; lifting the limit only lets new ones through.
+		if (level < LoadGovernor::stealVoices)
+			midiRouter.setVoiceLimit(0);
+
+		appliedLoadLevel = level;
+	}
+
+	// Each round keeps three quarters of what is sounding.
+	if (level == LoadGovernor::stealVoices && governor.takeStealRequest())
+	{
+		const auto current = midiRouter.getVoiceLimit() > 0 ? jmin(midiRouter.getVoiceLimit(), midiRouter.getNumSoundingNotes())
+		                                                     : midiRouter.getNumSoundingNotes();
+		midiRouter.setVoiceLimit(jmax(1, current * 3 / 4));
+	}
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -11,14 +11,28 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
-
-//using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+#include "ReferenceSynth.h"
+#include "MidiEventPool.h"
+#include "MidiRouter.h"
+#include "InstanceProcessor.h"
+#include "SandboxBridge.h"
+#include "ProgramBank.h"
+#include "GraphHistory.h"
+#include "PluginDatabase.h"
+#include "ParameterProxy.h"
+#include "LoadGovernor.h"
+#include "RenderSchedule.h"
+#include "AutosaveJournal.h"
+#include "IdlePolicy.h"
+
+using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
 using Node = AudioProcessorGraph::Node;
 
 //==============================================================================
 /**
 */
-class MicroChromoAudioProcessor  : public AudioProcessor
+class MicroChromoAudioProcessor  : public AudioProcessor,
+                                   private Timer
 {
 public:
     //==============================================================================
@@ -34,6 +48,7 @@ public:
    #endif
 
     void processBlock (AudioBuffer<float>&, MidiBuffer&) override;
+	void processBlockBypassed(AudioBuffer<float>&, MidiBuffer&) override;
 
     //==============================================================================
     AudioProcessorEditor* createEditor() override;
@@ -56,10 +71,88 @@ public:
 
 	//==============================================================================
 	void initializeGraph();
+	void reprepareGraph();
 	void connectAudioNodes();
 	void connectMidiNodes();
 	void updateGraph();
 
+	//==============================================================================
+	void setNumInstances(int newNumInstances);
+	int getNumInstances() const noexcept { return numInstances; }
+	static constexpr int maxAuxOutputs = 16;
+
+	/** Records the main output to mixFile and, optionally, each instance next to it. */
+	bool startRecording(const File& mixFile, bool includeInstances);
+	void stopRecording();
+	const DiskRecorder& getRecorder() const noexcept { return recorder; }
+
+	/** For diagnostics, e.g. the health counters; message thread only. */
+	InstanceProcessor* getInstanceProcessor(int index) const;
+
+	/** Lets instances isolated for producing NaNs or infinities render again. */
+	void clearIsolation();
+	void setBackend(const PluginDescription& description);
+	void useReferenceBackend();
+	void setSandboxEnabled(bool shouldRunOutOfProcess);
+	bool isSandboxEnabled() const noexcept { return sandboxEnabled; }
+	void setNoteOffsets(const Array<float>& centsPerNote);
+
+	/** Reads up to 128 offsets in cents, one per MIDI note, separated by whitespace. */
+	static Array<float> loadTuningFile(const File& file);
+	void setOutputMode(MidiRouter::OutputMode newMode);
+	void setMpeZone(bool useLowerZone, int numMemberChannels, int perNotePitchbendRange);
+	void setGlide(float retuneMs, float portamentoMs, GlideEngine::Shape shape);
+
+	/** Tunes to pure intervals over the root of the notes being played, instead of the note offsets. */
+	void setAdaptiveTuning(bool shouldAdapt, float driftLimitCents);
+	bool isAdaptiveTuningEnabled() const noexcept { return adaptiveTuning; }
+
+	/** Holds MIDI back so tuning bends can be sent ahead of their notes; adds to the reported latency. */
+	void setLookahead(int samples);
+	int getLookahead() const noexcept { return midiRouter.getLookahead(); }
+	static constexpr int maxLookaheadSamples = 48000;
+
+	/** Lines the instances up and reports the total latency now, rather than from the next message loop. */
+	void updateLatencyCompensation();
+
+	//==============================================================================
+	/** Stores the current settings as a new program and returns its index. */
+	int storeProgram(const String& name);
+	ProgramBank& getProgramBank() noexcept { return programBank; }
+
+	/** True from a program change made off the message thread until the message thread has applied it. */
+	bool isProgramChangePending() const noexcept { return pendingProgram.load() >= 0; }
+
+	/** Glide time for retuning sounding notes on program change, 0 for an instant switch. */
+	void setProgramCrossfade(float ms) { programCrossfadeMs = jmax(0.0f, ms); }
+
+	//==============================================================================
+	/** Trades quality for time when blocks come close to their deadline; off when rendering offline. */
+	void setLoadSheddingEnabled(bool shouldShedLoad) noexcept { governor.setEnabled(shouldShedLoad); }
+	const LoadGovernor& getLoadGovernor() const noexcept { return governor; }
+
+	/** Renders the instances from a flat schedule compiled along with the graph, rather than through the graph; off by default. */
+	void setTopologyFrozen(bool shouldFreeze) noexcept { topologyFrozen = shouldFreeze; }
+	bool isTopologyFrozen() const noexcept { return topologyFrozen.load(); }
+
+	/** Journals the session for crash recovery while prepared; on by default, never when rendering offline. */
+	void setAutosaveEnabled(bool shouldAutosave);
+
+	/** Winds the instances down while idle or released; see IdlePolicy. */
+	IdlePolicy& getIdlePolicy() noexcept { return idle; }
+	const IdlePolicy& getIdlePolicy() const noexcept { return idle; }
+
+	//==============================================================================
+	/** Lets the host automate a backend parameter through proxy slot; the value goes to every instance. */
+	bool mapParameter(int slot, int backendParameterIndex);
+	void unmapParameter(int slot);
+	ParameterProxyPool& getParameterProxies() noexcept { return proxies; }
+
+	//==============================================================================
+	/** Undo history of the edits made through the setters above. */
+	GraphHistory& getGraphHistory() noexcept { return history; }
+	UndoManager& getUndoManager() noexcept { return history.getUndoManager(); }
+
     //==============================================================================
     void getStateInformation (MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
@@ -71,7 +164,90 @@ private:
 	Node::Ptr audioOutputNode;
 	Node::Ptr midiInputNode;
 	Node::Ptr midiOutputNode;
-
+	Array<Node::Ptr> instanceNodes;
+	Array<AudioProcessor*> backends;
+	RenderSchedule schedule;
+	BusesLayout connectedLayout;
+	std::atomic<bool> latencyChanged{ false };
+	std::atomic<bool> topologyFrozen{ false };
+
+	static BusesProperties createBusesProperties();
+	static AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+	void timerCallback() override;
+
+	std::unique_ptr<AudioProcessor> createBackend();
+	void rebuildGraph();
+	void reprepareRouter();
+	void prepareMidiPool(int numNodes);
+	void prepareInstances();
+	void unloadInstances();
+	bool isBlockIdle() const noexcept;
+	bool usesPitchBendTuning() const noexcept;
+
+	ProgramSnapshot captureSettings() const;
+	void applyProgramStructure(const ProgramSnapshot& snapshot);
+	bool applyProgram(int index);
+	void applyLoadLevel() noexcept;
+	void applyNoteOffsets();
+
+	void recordEdit(const String& name);
+	GraphHistory::Topology captureTopology() const;
+	GraphHistory::Glide captureGlide() const;
+	Array<MemoryBlock> captureNodeStates();
+	void restoreInstanceStates(const Array<MemoryBlock>& states);
+	void restoreSnapshot(const GraphHistory::Snapshot& snapshot);
+
+	void startAutosave();
+	void captureAutosave();
+	void recoverAutosave(const String& savedId, int64 savedGeneration);
+	void applyRecoveredState(const AutosaveJournal::Contents& recovered);
+
+	SharedResourcePointer<PluginDatabase> pluginDatabase;
+
+	/** Prepares instances side by side; one set of threads for every processor in the process. */
+	struct PreparePool
+	{
+		ThreadPool pool{ jmax(1, SystemStats::getNumCpus()) };
+	};
+	SharedResourcePointer<PreparePool> preparers;
+	std::unique_ptr<PluginDescription> backendDescription;
+	int numInstances = 1;
+	bool sandboxEnabled = false;
+	Array<float> noteOffsets;
+	bool adaptiveTuning = false;
+	float adaptiveDriftCents = 20.0f;
+
+	DiskRecorder recorder;
+	MidiEventPool midiPool;
+	MidiRouter midiRouter{ midiPool };
+	MidiBuffer midiOutput;
+	LoadGovernor governor;
+	int appliedLoadLevel = -1;
+
+	bool mpeLowerZone = true;
+	int mpeNumMemberChannels = 15, mpePitchbendRange = 48;
+	float retuneGlideMs = 0.0f, portamentoGlideMs = 0.0f;
+	GlideEngine::Shape glideShape = GlideEngine::Shape::linear;
+
+	ProgramBank programBank{ *this };
+	int currentProgram = 0;
+	std::atomic<int> pendingProgram{ -1 };
+	std::atomic<float> programCrossfadeMs{ 0.0f };
+	static constexpr int pollIntervalMs = 20;
+
+	GraphHistory history{ [this](const GraphHistory::Snapshot& snapshot) { restoreSnapshot(snapshot); } };
+
+	AutosaveJournal journal{ [this] { captureAutosave(); } };
+	String autosaveId;
+	int autosaveInstance = 0;
+	bool autosaveEnabled = true;
+
+	IdlePolicy idle{ [this] { unloadInstances(); } };
+	Array<MemoryBlock> unloadedStates;
+	CriticalSection idleLock;
+
+	ParameterProxyPool proxies;
 	AudioProcessorValueTreeState parameters;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MicroChromoAudioProcessor)
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    ProgramBank.cpp
+    Created: 19 Oct 2026 5:24:40pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "ProgramBank.h"
+
+const Identifier ProgramBank::bankType("Programs");
+const Identifier ProgramBank::programType("Program");
+
+namespace
+{
+	const Identifier nameId("name");
+	const Identifier tuningId("tuning");
+	const Identifier numInstancesId("numInstances");
+	const Identifier outputModeId("outputMode");
+	const Identifier mpeLowerZoneId("mpeLowerZone");
+	const Identifier mpeNumMemberChannelsId("mpeNumMemberChannels");
+	const Identifier mpePitchbendRangeId("mpePitchbendRange");
+	const Identifier retuneMsId("retuneMs");
+	const Identifier portamentoMsId("portamentoMs");
+	const Identifier glideShapeId("glideShape");
+	const Identifier sandboxedId("sandboxed");
+	const Identifier backendId("backend");
+	const Identifier parametersId("parameters");
+}
+
+//==============================================================================
+bool ProgramSnapshot::hasSameStructure(const ProgramSnapshot& other) const
+{
+	if (outputMode != other.outputMode || sandboxed != other.sandboxed)
+		return false;
+
+	if (outputMode == MidiRouter::OutputMode::clones && numInstances != other.numInstances)
+		return false;
+
+	if (outputMode == MidiRouter::OutputMode::mpe
+		&& (mpeLowerZone != other.mpeLowerZone
+			|| mpeNumMemberChannels != other.mpeNumMemberChannels
+			|| mpePitchbendRange != other.mpePitchbendRange))
+		return false;
+
+	if (backend == nullptr || other.backend == nullptr)
+		return backend == other.backend;
+
+	return backend->isDuplicateOf(*other.backend);
+}
+
+//==============================================================================
+ProgramBank::ProgramBank(AudioProcessor& o) : owner(o)
+{
+}
+
+ProgramBank::~ProgramBank()
+{
+	decoder.removeAllJobs(true, 2000);
+}
+
+int ProgramBank::getNumPrograms() const
+{
+	const ScopedLock sl(lock);
+	return programs.size();
+}
+
+String ProgramBank::getProgramName(int index) const
+{
+	const ScopedLock sl(lock);
+	if (auto* program = programs[index])
+		return program->name;
+	return {};
+}
+
+void ProgramBank::setProgramName(int index, const String& newName)
+{
+	const ScopedLock sl(lock);
+	if (auto* program = programs[index])
+		program->name = newName;
+}
+
+int ProgramBank::addProgram(const String& name, const ValueTree& state)
+{
+	int index;
+	{
+		const ScopedLock sl(lock);
+		auto* program = programs.add(new Program());
+		program->name = name;
+		index = programs.size() - 1;
+	}
+
+	setProgramState(index, state);
+	return index;
+}
+
+void ProgramBank::setProgramState(int index, const ValueTree& state)
+{
+	{
+		const ScopedLock sl(lock);
+		auto* program = programs[index];
+		if (program == nullptr)
+			return;
+
+		program->state = state.createCopy();
+		program->snapshot = nullptr;
+		program->generation = ++nextGeneration;
+	}
+
+	startDecoding(index);
+}
+
+void ProgramBank::removeProgram(int index)
+{
+	const ScopedLock sl(lock);
+	programs.remove(index);
+}
+
+void ProgramBank::clear()
+{
+	const ScopedLock sl(lock);
+	programs.clear();
+}
+
+std::shared_ptr<const ProgramSnapshot> ProgramBank::getSnapshot(int index)
+{
+	ValueTree state;
+	uint32 generation;
+	{
+		const ScopedLock sl(lock);
+		auto* program = programs[index];
+		if (program == nullptr)
+			return nullptr;
+
+		if (program->snapshot != nullptr)
+			return program->snapshot;
+
+		state = program->state.createCopy();
+		generation = program->generation;
+	}
+
+	auto snapshot = decode(state);
+
+	const ScopedLock sl(lock);
+	for (auto* program : programs)
+		if (program->generation == generation)
+			program->snapshot = snapshot;
+
+	return snapshot;
+}
+
+//==============================================================================
+void ProgramBank::startDecoding(int index)
+{
+	ValueTree state;
+	uint32 generation;
+	{
+		const ScopedLock sl(lock);
+		auto* program = programs[index];
+		if (program == nullptr)
+			return;
+
+		// The job gets its own copy, as ValueTrees are not safe to share across threads.
+		state = program->state.createCopy();
+		generation = program->generation;
+	}
+
+	decoder.addJob([this, state, generation]
+	{
+		auto snapshot = decode(state);
+
+		// Programs may have been moved, removed or overwritten in the meantime,
+		// so the result goes to whichever program still carries the generation.
+		const ScopedLock sl(lock);
+		for (auto* program : programs)
+			if (program->generation == generation && program->snapshot == nullptr)
+				program->snapshot = snapshot;
+	});
+}
+
+std::shared_ptr<const ProgramSnapshot> ProgramBank::decode(const ValueTree& state) const
+{
+	auto snapshot = std::make_shared<ProgramSnapshot>();
+
+	snapshot->noteOffsets.insertMultiple(0, 0.0f, 128);
+	auto tokens = StringArray::fromTokens(state[tuningId].toString(), false);
+	for (int i = 0; i < jmin(128, tokens.size()); ++i)
+		snapshot->noteOffsets.set(i, tokens[i].getFloatValue());
+
+	snapshot->numInstances = jlimit(1, 64, (int)state.getProperty(numInstancesId, 1));
+	snapshot->outputMode = (int)state[outputModeId] == (int)MidiRouter::OutputMode::mpe
+		? MidiRouter::OutputMode::mpe : MidiRouter::OutputMode::clones;
+	snapshot->mpeLowerZone = state.getProperty(mpeLowerZoneId, true);
+	snapshot->mpeNumMemberChannels = state.getProperty(mpeNumMemberChannelsId, 15);
+	snapshot->mpePitchbendRange = state.getProperty(mpePitchbendRangeId, 48);
+	snapshot->retuneMs = state[retuneMsId];
+	snapshot->portamentoMs = state[portamentoMsId];
+	snapshot->glideShape = (GlideEngine::Shape)jlimit(0, (int)GlideEngine::Shape::custom, (int)state[glideShapeId]);
+	snapshot->sandboxed = state[sandboxedId];
+
+	auto backend = state.getChildWithName(backendId);
+	if (backend.getNumChildren() > 0)
+	{
+		std::unique_ptr<XmlElement> xml(backend.getChild(0).createXml());
+		auto description = std::make_unique<PluginDescription>();
+		if (xml != nullptr && description->loadFromXml(*xml))
+			snapshot->backend = std::move(description);
+	}
+
+	// Resolve parameter IDs to indices now, so recall is a plain loop over values.
+	auto parameterState = state.getChildWithName(parametersId).getChild(0);
+	const auto& parameters = owner.getParameters();
+
+	for (int i = 0; i < parameters.size(); ++i)
+	{
+		auto* parameter = dynamic_cast<RangedAudioParameter*>(parameters.getUnchecked(i));
+		if (parameter == nullptr)
+			continue;
+
+		auto child = parameterState.getChildWithProperty("id", parameter->paramID);
+		if (child.isValid() && child.hasProperty("value"))
+			snapshot->parameterValues.add({ i, parameter->convertTo0to1((float)child["value"]) });
+	}
+
+	return snapshot;
+}
+
+ValueTree ProgramBank::encode(const ProgramSnapshot& settings, const ValueTree& parameterState)
+{
+	ValueTree state(programType);
+
+	StringArray tuning;
+	for (auto cents : settings.noteOffsets)
+		tuning.add(String(cents));
+
+	state.setProperty(tuningId, tuning.joinIntoString(" "), nullptr);
+	state.setProperty(numInstancesId, settings.numInstances, nullptr);
+	state.setProperty(outputModeId, (int)settings.outputMode, nullptr);
+	state.setProperty(mpeLowerZoneId, settings.mpeLowerZone, nullptr);
+	state.setProperty(mpeNumMemberChannelsId, settings.mpeNumMemberChannels, nullptr);
+	state.setProperty(mpePitchbendRangeId, settings.mpePitchbendRange, nullptr);
+	state.setProperty(retuneMsId, settings.retuneMs, nullptr);
+	state.setProperty(portamentoMsId, settings.portamentoMs, nullptr);
+	state.setProperty(glideShapeId, (int)settings.glideShape, nullptr);
+	state.setProperty(sandboxedId, settings.sandboxed, nullptr);
+
+	ValueTree backend(backendId);
+	if (settings.backend != nullptr)
+	{
+		std::unique_ptr<XmlElement> xml(settings.backend->createXml());
+		backend.appendChild(ValueTree::fromXml(*xml), nullptr);
+	}
+	state.appendChild(backend, nullptr);
+
+	ValueTree parameters(parametersId);
+	parameters.appendChild(parameterState.createCopy(), nullptr);
+	state.appendChild(parameters, nullptr);
+
+	return state;
+}
+
+//==============================================================================
+ValueTree ProgramBank::toValueTree() const
+{
+	ValueTree tree(bankType);
+
+	const ScopedLock sl(lock);
+	for (auto* program : programs)
+	{
+		auto child = program->state.createCopy();
+		child.setProperty(nameId, program->name, nullptr);
+		tree.appendChild(child, nullptr);
+	}
+
+	return tree;
+}
+
+void ProgramBank::fromValueTree(const ValueTree& tree)
+{
+	decoder.removeAllJobs(true, 2000);
+	clear();
+
+	for (const auto& child : tree)
+		if (child.hasType(programType))
+			addProgram(child[nameId], child);
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+    Created: 19 Oct 2026 5:24:40pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MidiRouter.h"
+
+//==============================================================================
+/**
+    Everything a program sets, already decoded into the form the processor
+    applies: tuning table, voice allocation, backend and parameter values
+    resolved to parameter indices.
+*/
+struct ProgramSnapshot
+{
+	struct ParameterValue
+	{
+		int index;
+		float normalisedValue;
+	};
+
+	Array<float> noteOffsets;
+	int numInstances = 1;
+	MidiRouter::OutputMode outputMode = MidiRouter::OutputMode::clones;
+	bool mpeLowerZone = true;
+	int mpeNumMemberChannels = 15, mpePitchbendRange = 48;
+	float retuneMs = 0.0f, portamentoMs = 0.0f;
+	GlideEngine::Shape glideShape = GlideEngine::Shape::linear;
+	std::unique_ptr<PluginDescription> backend;
+	bool sandboxed = false;
+	Array<ParameterValue> parameterValues;
+
+	/** True if switching between the two only needs new values, not a new graph. */
+	bool hasSameStructure(const ProgramSnapshot& other) const;
+};
+
+//==============================================================================
+/**
+    A list of named programs, each kept both as its saved state and as a
+    ProgramSnapshot decoded on a background thread.
+
+    Recalling a program then costs no parsing or lookups: the processor
+    takes the snapshot and applies its values as they are.
+*/
+class ProgramBank
+{
+public:
+	ProgramBank(AudioProcessor& owner);
+	~ProgramBank();
+
+	//==============================================================================
+	int getNumPrograms() const;
+	String getProgramName(int index) const;
+	void setProgramName(int index, const String& newName);
+
+	int addProgram(const String& name, const ValueTree& state);
+	void setProgramState(int index, const ValueTree& state);
+	void removeProgram(int index);
+	void clear();
+
+	/** Returns the decoded program, decoding it here if the background job has not finished yet. */
+	std::shared_ptr<const ProgramSnapshot> getSnapshot(int index);
+
+	/** Builds a program state from the settings in a snapshot and the parameter state. */
+	static ValueTree encode(const ProgramSnapshot& settings, const ValueTree& parameterState);
+
+	//==============================================================================
+	ValueTree toValueTree() const;
+	void fromValueTree(const ValueTree& tree);
+
+	static const Identifier bankType, programType;
+
+private:
+	//==============================================================================
+	struct Program
+	{
+		String name;
+		ValueTree state;
+		std::shared_ptr<const ProgramSnapshot> snapshot;
+		uint32 generation = 0;
+	};
+
+	void startDecoding(int index);
+	std::shared_ptr<const ProgramSnapshot> decode(const ValueTree& state) const;
+
+	AudioProcessor& owner;
+	OwnedArray<Program> programs;
+	uint32 nextGeneration = 0;
+	CriticalSection lock;
+	ThreadPool decoder{ 1 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProgramBank)
+};
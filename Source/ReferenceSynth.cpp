@@ -0,0 +1,292 @@
+/*
+  ==============================================================================
+
+    ReferenceSynth.cpp
+    Created: 19 Oct 2026 9:12:40am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "ReferenceSynth.h"
+
+namespace
+{
+	constexpr float attackSeconds = 0.005f;
+	constexpr float releaseSeconds = 0.050f;
+	constexpr int maxSubBlockSize = 64;
+
+	// Parabolic sine with one refinement step, |error| < 0.001.
+	// Takes t in [-0.5, 0.5) and returns roughly sin (2 pi t).
+	inline float fastSine(float t) noexcept
+	{
+		auto y = 8.0f * t - 16.0f * t * std::abs(t);
+		return 0.225f * (y * std::abs(y) - y) + y;
+	}
+}
+
+//==============================================================================
+ReferenceSynth::ReferenceSynth()
+	: AudioProcessor(BusesProperties().withOutput("Output", AudioChannelSet::stereo(), true))
+{
+	std::fill(std::begin(phase), std::end(phase), 0.0f);
+	std::fill(std::begin(phaseDelta), std::end(phaseDelta), 0.0f);
+	std::fill(std::begin(gain), std::end(gain), 0.0f);
+	std::fill(std::begin(gainDelta), std::end(gainDelta), 0.0f);
+	std::fill(std::begin(peakGain), std::end(peakGain), 0.0f);
+	std::fill(std::begin(voiceNote), std::end(voiceNote), (int8)0);
+	std::fill(std::begin(voiceChannel), std::end(voiceChannel), (int8)0);
+	std::fill(std::begin(voiceReleased), std::end(voiceReleased), false);
+	std::fill(std::begin(channelBend), std::end(channelBend), 0.0f);
+	std::fill(std::begin(noteOffsets), std::end(noteOffsets), 0.0f);
+
+	pendingNoteOffsets.insertMultiple(0, 0.0f, 128);
+}
+
+ReferenceSynth::~ReferenceSynth()
+{
+}
+
+//==============================================================================
+void ReferenceSynth::setPitchBendRange(float semitones)
+{
+	pitchBendRange = jmax(0.0f, semitones);
+}
+
+void ReferenceSynth::setNoteOffsets(const Array<float>& centsPerNote)
+{
+	{
+		const SpinLock::ScopedLockType sl(noteOffsetLock);
+		for (int i = 0; i < 128; ++i)
+			pendingNoteOffsets.set(i, centsPerNote[i]);
+	}
+	noteOffsetsChanged = true;
+}
+
+void ReferenceSynth::pullPendingNoteOffsets()
+{
+	if (!noteOffsetsChanged.load())
+		return;
+
+	const SpinLock::ScopedTryLockType sl(noteOffsetLock);
+	if (!sl.isLocked())
+		return;
+
+	for (int i = 0; i < 128; ++i)
+		noteOffsets[i] = pendingNoteOffsets.getUnchecked(i);
+	noteOffsetsChanged = false;
+
+	for (int v = 0; v < numActiveVoices; ++v)
+		updateVoiceFrequency(v);
+}
+
+//==============================================================================
+void ReferenceSynth::prepareToPlay(double sampleRate, int)
+{
+	currentSampleRate = sampleRate;
+
+	for (int v = 0; v < maxVoices; ++v)
+	{
+		gain[v] = gainDelta[v] = peakGain[v] = phaseDelta[v] = 0.0f;
+		voiceReleased[v] = false;
+	}
+	numActiveVoices = 0;
+	std::fill(std::begin(channelBend), std::end(channelBend), 0.0f);
+}
+
+void ReferenceSynth::releaseResources()
+{
+}
+
+bool ReferenceSynth::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+	return layouts.getMainInputChannelSet().isDisabled()
+		&& (layouts.getMainOutputChannelSet() == AudioChannelSet::mono()
+			|| layouts.getMainOutputChannelSet() == AudioChannelSet::stereo());
+}
+
+//==============================================================================
+void ReferenceSynth::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+{
+	ScopedNoDenormals noDenormals;
+	pullPendingNoteOffsets();
+
+	auto numSamples = buffer.getNumSamples();
+	auto* out = buffer.getWritePointer(0);
+
+	MidiBuffer::Iterator it(midiMessages);
+	const uint8* data;
+	int numBytes, eventPos;
+	auto hasEvent = it.getNextEvent(data, numBytes, eventPos);
+
+	int pos = 0;
+	while (pos < numSamples)
+	{
+		while (hasEvent && eventPos <= pos)
+		{
+			handleMidiEvent(data, numBytes);
+			hasEvent = it.getNextEvent(data, numBytes, eventPos);
+		}
+
+		auto end = jmin(numSamples, pos + maxSubBlockSize);
+		if (hasEvent && eventPos < end)
+			end = eventPos;
+
+		renderVoices(out + pos, end - pos);
+		removeFinishedVoices();
+		pos = end;
+	}
+
+	while (hasEvent)
+	{
+		handleMidiEvent(data, numBytes);
+		hasEvent = it.getNextEvent(data, numBytes, eventPos);
+	}
+
+	for (int ch = 1; ch < buffer.getNumChannels(); ++ch)
+		buffer.copyFrom(ch, 0, buffer, 0, 0, numSamples);
+}
+
+void ReferenceSynth::renderVoices(float* out, int numSamples)
+{
+	// Lanes are independent, so the inner loop maps onto SIMD registers
+	// without needing the compiler to reorder the floating point sum.
+	const auto numLanes = (numActiveVoices + laneWidth - 1) / laneWidth * laneWidth;
+
+	if (numLanes == 0)
+	{
+		FloatVectorOperations::clear(out, numSamples);
+		return;
+	}
+
+	for (int s = 0; s < numSamples; ++s)
+	{
+		float acc[laneWidth] = {};
+
+		for (int base = 0; base < numLanes; base += laneWidth)
+		{
+			for (int l = 0; l < laneWidth; ++l)
+			{
+				const auto v = base + l;
+				auto p = phase[v] + phaseDelta[v];
+				p -= (float)(int)p;
+				phase[v] = p;
+
+				auto g = jlimit(0.0f, peakGain[v], gain[v] + gainDelta[v]);
+				gain[v] = g;
+
+				acc[l] += g * fastSine(p - 0.5f);
+			}
+		}
+
+		auto sum = 0.0f;
+		for (int l = 0; l < laneWidth; ++l)
+			sum += acc[l];
+		out[s] = sum;
+	}
+}
+
+void ReferenceSynth::removeFinishedVoices()
+{
+	for (int v = numActiveVoices; --v >= 0;)
+	{
+		if (voiceReleased[v] && gain[v] <= 0.0f)
+		{
+			const auto last = --numActiveVoices;
+
+			phase[v] = phase[last];
+			phaseDelta[v] = phaseDelta[last];
+			gain[v] = gain[last];
+			gainDelta[v] = gainDelta[last];
+			peakGain[v] = peakGain[last];
+			voiceNote[v] = voiceNote[last];
+			voiceChannel[v] = voiceChannel[last];
+			voiceReleased[v] = voiceReleased[last];
+
+			gain[last] = gainDelta[last] = peakGain[last] = phaseDelta[last] = 0.0f;
+			voiceReleased[last] = false;
+		}
+	}
+}
+
+//==============================================================================
+void ReferenceSynth::handleMidiEvent(const uint8* data, int numBytes)
+{
+	if (numBytes < 2)
+		return;
+
+	const auto status = data[0] & 0xf0;
+	const auto channel = data[0] & 0x0f;
+
+	if (status == 0x90 && numBytes >= 3 && data[2] > 0)
+	{
+		startVoice(channel, data[1], data[2] / 127.0f);
+	}
+	else if (status == 0x80 || (status == 0x90 && numBytes >= 3))
+	{
+		stopVoice(channel, data[1]);
+	}
+	else if (status == 0xe0 && numBytes >= 3)
+	{
+		const auto value = (data[1] & 0x7f) | ((data[2] & 0x7f) << 7);
+		channelBend[channel] = (value - 8192) / 8192.0f * pitchBendRange.load();
+
+		for (int v = 0; v < numActiveVoices; ++v)
+			if (voiceChannel[v] == channel)
+				updateVoiceFrequency(v);
+	}
+	else if (status == 0xb0 && numBytes >= 3 && (data[1] == 120 || data[1] == 123))
+	{
+		for (int v = 0; v < numActiveVoices; ++v)
+			if (voiceChannel[v] == channel)
+				stopVoice(channel, voiceNote[v]);
+	}
+}
+
+void ReferenceSynth::startVoice(int channel, int note, float velocity)
+{
+	int v = numActiveVoices;
+
+	if (v == maxVoices)
+	{
+		// Steal the quietest voice.
+		v = 0;
+		for (int i = 1; i < maxVoices; ++i)
+			if (gain[i] < gain[v])
+				v = i;
+	}
+	else
+	{
+		++numActiveVoices;
+		phase[v] = 0.0f;
+		gain[v] = 0.0f;
+	}
+
+	voiceNote[v] = (int8)note;
+	voiceChannel[v] = (int8)channel;
+	voiceReleased[v] = false;
+	peakGain[v] = velocity * 0.1f;
+	gainDelta[v] = peakGain[v] / jmax(1.0f, attackSeconds * (float)currentSampleRate);
+	updateVoiceFrequency(v);
+}
+
+void ReferenceSynth::stopVoice(int channel, int note)
+{
+	for (int v = 0; v < numActiveVoices; ++v)
+	{
+		if (!voiceReleased[v] && voiceChannel[v] == channel && voiceNote[v] == note)
+		{
+			voiceReleased[v] = true;
+			gainDelta[v] = -peakGain[v] / jmax(1.0f, releaseSeconds * (float)currentSampleRate);
+		}
+	}
+}
+
+void ReferenceSynth::updateVoiceFrequency(int voice)
+{
+	const auto note = (int)voiceNote[voice];
+	const auto semitones = (float)(note - 69) + noteOffsets[note] * 0.01f + channelBend[(int)voiceChannel[voice]];
+	const auto hz = 440.0 * std::pow(2.0, semitones / 12.0);
+
+	phaseDelta[voice] = (float)jmin(0.5, hz / currentSampleRate);
+}
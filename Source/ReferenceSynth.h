@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    ReferenceSynth.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A built-in sine oscillator bank that can stand in for a hosted backend.
+
+    Every voice carries its own frequency, so microtonal offsets are applied
+    directly instead of through pitch bend. Voice state is kept in
+    structure-of-arrays form and rendered lane by lane so the inner loop
+    vectorises.
+*/
+class ReferenceSynth : public AudioProcessor
+{
+public:
+	static constexpr int maxVoices = 256;
+	static constexpr int laneWidth = 8;
+
+	//==============================================================================
+	ReferenceSynth();
+	~ReferenceSynth();
+
+	//==============================================================================
+	void setPitchBendRange(float semitones);
+	void setNoteOffsets(const Array<float>& centsPerNote);
+	int getNumActiveVoices() const noexcept { return numActiveVoices; }
+
+	//==============================================================================
+	const String getName() const override { return "Reference Synth"; }
+
+	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+	void releaseResources() override;
+	void processBlock(AudioBuffer<float>&, MidiBuffer&) override;
+
+	bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+
+	double getTailLengthSeconds() const override { return 0.0; }
+	bool acceptsMidi() const override { return true; }
+	bool producesMidi() const override { return false; }
+
+	AudioProcessorEditor* createEditor() override { return nullptr; }
+	bool hasEditor() const override { return false; }
+
+	int getNumPrograms() override { return 1; }
+	int getCurrentProgram() override { return 0; }
+	void setCurrentProgram(int) override {}
+	const String getProgramName(int) override { return {}; }
+	void changeProgramName(int, const String&) override {}
+
+	void getStateInformation(MemoryBlock&) override {}
+	void setStateInformation(const void*, int) override {}
+
+private:
+	//==============================================================================
+	void handleMidiEvent(const uint8* data, int numBytes);
+	void startVoice(int channel, int note, float velocity);
+	void stopVoice(int channel, int note);
+	void updateVoiceFrequency(int voice);
+	void renderVoices(float* out, int numSamples);
+	void removeFinishedVoices();
+	void pullPendingNoteOffsets();
+
+	//==============================================================================
+	// Per-voice state, one slot per voice; slots past numActiveVoices are kept
+	// silent so whole lanes can be rendered without a tail loop.
+	alignas(32) float phase[maxVoices];
+	alignas(32) float phaseDelta[maxVoices];
+	alignas(32) float gain[maxVoices];
+	alignas(32) float gainDelta[maxVoices];
+	alignas(32) float peakGain[maxVoices];
+
+	int8 voiceNote[maxVoices];
+	int8 voiceChannel[maxVoices];
+	bool voiceReleased[maxVoices];
+	int numActiveVoices = 0;
+
+	float channelBend[16];
+	float noteOffsets[128];
+	std::atomic<float> pitchBendRange{ 2.0f };
+	double currentSampleRate = 44100.0;
+
+	Array<float> pendingNoteOffsets;
+	std::atomic<bool> noteOffsetsChanged{ false };
+	SpinLock noteOffsetLock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReferenceSynth)
+};
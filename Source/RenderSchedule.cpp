@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    RenderSchedule.cpp
+    Created: 20 Oct 2026 12:48:31am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "RenderSchedule.h"
+
+//==============================================================================
+RenderSchedule::RenderSchedule()
+{
+}
+
+RenderSchedule::~RenderSchedule()
+{
+}
+
+void RenderSchedule::clear()
+{
+	steps.clear();
+	unusedChannels.clear();
+	renderFunction = nullptr;
+	allPrepared = false;
+}
+
+int RenderSchedule::addInstance(InstanceProcessor* instance)
+{
+	jassert(instance != nullptr);
+
+	Step step;
+	step.instance = instance;
+	steps.push_back(step);
+	return (int)steps.size() - 1;
+}
+
+void RenderSchedule::addRoute(int step, int instanceChannel, int outputChannel)
+{
+	jassert(isPositiveAndBelow(step, (int)steps.size()) && isPositiveAndBelow(instanceChannel, 2));
+	steps[(size_t)step].outputChannels[instanceChannel] = outputChannel;
+}
+
+void RenderSchedule::compile(int numOutputs, int maxBlockSize)
+{
+	numOutputChannels = numOutputs;
+	blockCapacity = maxBlockSize;
+	scratch.setSize(2, jmax(1, maxBlockSize));
+
+	// The first step to write a channel overwrites it, the later ones add.
+	std::vector<uint8> written((size_t)jmax(0, numOutputs), 0);
+	for (auto& step : steps)
+	{
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			const auto output = step.outputChannels[channel];
+			if (!isPositiveAndBelow(output, numOutputs))
+			{
+				step.outputChannels[channel] = -1;
+				continue;
+			}
+
+			step.accumulate[channel] = written[(size_t)output] != 0;
+			written[(size_t)output] = 1;
+		}
+	}
+
+	unusedChannels.clear();
+	for (int output = 0; output < numOutputs; ++output)
+		if (written[(size_t)output] == 0)
+			unusedChannels.push_back(output);
+
+	switch (steps.size())
+	{
+		case 1:  renderFunction = &RenderSchedule::renderSteps<1>; break;
+		case 2:  renderFunction = &RenderSchedule::renderSteps<2>; break;
+		case 4:  renderFunction = &RenderSchedule::renderSteps<4>; break;
+		case 8:  renderFunction = &RenderSchedule::renderSteps<8>; break;
+		case 16: renderFunction = &RenderSchedule::renderSteps<16>; break;
+		default: renderFunction = &RenderSchedule::renderAnySteps; break;
+	}
+
+	allPrepared = false;
+}
+
+void RenderSchedule::releaseScratch()
+{
+	scratch.setSize(0, 0);
+	blockCapacity = 0;
+}
+
+//==============================================================================
+bool RenderSchedule::render(AudioBuffer<float>& buffer) noexcept
+{
+	const auto numSamples = buffer.getNumSamples();
+
+	if (renderFunction == nullptr || numSamples > blockCapacity || buffer.getNumChannels() < numOutputChannels)
+		return false;
+
+	// The graph prepares new instances asynchronously; once they all are,
+	// they stay so until the next compile.
+	if (!allPrepared)
+	{
+		for (auto& step : steps)
+			if (!step.instance->isPrepared())
+				return false;
+
+		allPrepared = true;
+	}
+
+	auto* const* outputs = buffer.getArrayOfWritePointers();
+	(this->*renderFunction)(outputs, numSamples);
+
+	for (auto channel : unusedChannels)
+		FloatVectorOperations::clear(outputs[channel], numSamples);
+
+	return true;
+}
+
+forcedinline void RenderSchedule::renderStep(const Step& step, float* const* outputs, int numSamples) noexcept
+{
+	AudioBuffer<float> block(scratch.getArrayOfWritePointers(), 2, numSamples);
+	step.instance->processBlock(block, noMidi);
+
+	// An instance that has gone quiet hands back a cleared buffer, which
+	// only matters to the channels it writes first.
+	const auto silent = block.hasBeenCleared();
+
+	for (int channel = 0; channel < 2; ++channel)
+	{
+		const auto output = step.outputChannels[channel];
+		if (output < 0)
+			continue;
+
+		if (step.accumulate[channel])
+		{
+			if (!silent)
+				FloatVectorOperations::add(outputs[output], block.getReadPointer(channel), numSamples);
+		}
+		else if (silent)
+		{
+			FloatVectorOperations::clear(outputs[output], numSamples);
+		}
+		else
+		{
+			FloatVectorOperations::copy(outputs[output], block.getReadPointer(channel), numSamples);
+		}
+	}
+}
+
+template <int fixedNumSteps>
+void RenderSchedule::renderSteps(float* const* outputs, int numSamples) noexcept
+{
+	jassert((int)steps.size() == fixedNumSteps);
+	renderUnrolled(outputs, numSamples, std::make_integer_sequence<int, fixedNumSteps>());
+}
+
+template <int... stepIndices>
+forcedinline void RenderSchedule::renderUnrolled(float* const* outputs, int numSamples, std::integer_sequence<int, stepIndices...>) noexcept
+{
+	const auto* first = steps.data();
+	(renderStep(first[stepIndices], outputs, numSamples), ...);
+}
+
+void RenderSchedule::renderAnySteps(float* const* outputs, int numSamples) noexcept
+{
+	for (auto& step : steps)
+		renderStep(step, outputs, numSamples);
+}
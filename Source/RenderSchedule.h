@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    RenderSchedule.h
+    Created: 20 Oct 2026 12:48:31am
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "InstanceProcessor.h"
+
+//==============================================================================
+/**
+    The processor's graph flattened into a fixed list of render steps, for
+    as long as its topology stays the same.
+
+    The graph only ever runs the instances side by side and adds their
+    outputs onto the host's channels. Its render sequence still goes through
+    a generic op per node and per connection and looks up buffers every
+    block. Here each instance gets one step holding its processor and the
+    output channels it writes, and whether it is the first to write each of
+    them, so it copies instead of adding and the output needs no clearing.
+    Channels nothing writes to are listed once, and cleared.
+
+    Every instance renders into the same preallocated scratch buffer, one
+    after the other. For the usual instance counts, 1, 2, 4, 8 and 16, the
+    steps are rendered by a function with the count fixed at compile time,
+    which expands to one inlined step after another with no loop around
+    them; the right one is picked when compiling. Other counts loop.
+
+    The schedule is built on the message thread while the audio is stopped,
+    the same times the graph is rebuilt. Until the graph has prepared every
+    instance, render() returns false and the graph renders instead.
+*/
+class RenderSchedule
+{
+public:
+	RenderSchedule();
+	~RenderSchedule();
+
+	//==============================================================================
+	/** Message thread, with the audio stopped. */
+	void clear();
+	int addInstance(InstanceProcessor* instance);
+	void addRoute(int step, int instanceChannel, int outputChannel);
+	void compile(int numOutputChannels, int maxBlockSize);
+
+	/** Frees the scratch buffer; render() declines until the next compile(). */
+	void releaseScratch();
+
+	bool isCompiled() const noexcept { return renderFunction != nullptr; }
+	int getNumSteps() const noexcept { return (int)steps.size(); }
+
+	//==============================================================================
+	/** Audio thread: renders every instance into buffer, or returns false if the graph must do it. */
+	bool render(AudioBuffer<float>& buffer) noexcept;
+
+private:
+	//==============================================================================
+	struct Step
+	{
+		InstanceProcessor* instance = nullptr;
+		int outputChannels[2] = { -1, -1 };
+		bool accumulate[2] = { false, false };
+	};
+
+	using RenderFunction = void (RenderSchedule::*)(float* const* outputs, int numSamples) noexcept;
+
+	template <int fixedNumSteps>
+	void renderSteps(float* const* outputs, int numSamples) noexcept;
+	template <int... stepIndices>
+	void renderUnrolled(float* const* outputs, int numSamples, std::integer_sequence<int, stepIndices...>) noexcept;
+	void renderAnySteps(float* const* outputs, int numSamples) noexcept;
+	void renderStep(const Step& step, float* const* outputs, int numSamples) noexcept;
+
+	std::vector<Step> steps;
+	std::vector<int> unusedChannels;
+	RenderFunction renderFunction = nullptr;
+
+	AudioBuffer<float> scratch;
+	MidiBuffer noMidi;
+	int numOutputChannels = 0, blockCapacity = 0;
+	bool allPrepared = false;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderSchedule)
+};
@@ -0,0 +1,639 @@
+/*
+  ==============================================================================
+
+    SandboxBridge.cpp
+    Created: 19 Oct 2026 3:36:18pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "SandboxBridge.h"
+
+#if JUCE_LINUX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <climits>
+ #include <ctime>
+#endif
+
+const char* const SandboxedProcessor::commandLineUid = "microchromobridge";
+
+namespace
+{
+	constexpr int maxChannels = 8;
+	constexpr int midiBytesPerSlot = 32768;
+	constexpr int numSlots = 2;
+	constexpr int headerBytes = 64;
+	constexpr int spinIterations = 2000;
+
+	struct SharedHeader
+	{
+		std::atomic<uint32> requestSeq;
+		std::atomic<uint32> responseSeq;
+		std::atomic<int32> latencySamples;
+		std::atomic<int32> ready;
+		int32 maxBlockSize;
+		int32 numChannels;
+	};
+
+	struct SlotHeader
+	{
+		int32 numSamples;
+		int32 numMidiBytes;
+	};
+
+	static_assert(sizeof(SharedHeader) <= headerBytes, "Shared header does not fit");
+
+	size_t getSlotBytes(int maxBlockSize)
+	{
+		return (size_t)headerBytes + sizeof(float) * (size_t)(maxChannels * maxBlockSize) + (size_t)midiBytesPerSlot;
+	}
+
+	size_t getTotalBytes(int maxBlockSize)
+	{
+		return (size_t)headerBytes + (size_t)numSlots * getSlotBytes(maxBlockSize);
+	}
+
+	//==============================================================================
+	void wakeWaiters(std::atomic<uint32>& word) noexcept
+	{
+	   #if JUCE_LINUX
+		syscall(SYS_futex, reinterpret_cast<uint32*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+	   #else
+		ignoreUnused(word);
+	   #endif
+	}
+
+	void waitOnWord(std::atomic<uint32>& word, uint32 value, double timeoutMs) noexcept
+	{
+	   #if JUCE_LINUX
+		// Not FUTEX_PRIVATE: the word lives in memory shared with another process.
+		timespec timeout;
+		timeout.tv_sec = (time_t)(timeoutMs / 1000.0);
+		timeout.tv_nsec = (long)((timeoutMs - (double)timeout.tv_sec * 1000.0) * 1.0e6);
+		syscall(SYS_futex, reinterpret_cast<uint32*>(&word), FUTEX_WAIT, value, &timeout, nullptr, 0);
+	   #else
+		ignoreUnused(word, value, timeoutMs);
+		Thread::yield();
+	   #endif
+	}
+
+	/** Spins briefly, then blocks until the word differs from value or the timeout passes. */
+	uint32 waitForChange(std::atomic<uint32>& word, uint32 value, double timeoutMs) noexcept
+	{
+		for (int i = 0; i < spinIterations; ++i)
+		{
+			const auto current = word.load(std::memory_order_acquire);
+			if (current != value)
+				return current;
+		}
+
+		const auto deadline = Time::getMillisecondCounterHiRes() + timeoutMs;
+		for (;;)
+		{
+			const auto current = word.load(std::memory_order_acquire);
+			if (current != value)
+				return current;
+
+			const auto remaining = deadline - Time::getMillisecondCounterHiRes();
+			if (remaining <= 0.0)
+				return current;
+
+			waitOnWord(word, value, remaining);
+		}
+	}
+
+	//==============================================================================
+	ValueTree descriptionToTree(const PluginDescription& d)
+	{
+		ValueTree tree("plugin");
+		tree.setProperty("name", d.name, nullptr);
+		tree.setProperty("descriptiveName", d.descriptiveName, nullptr);
+		tree.setProperty("pluginFormatName", d.pluginFormatName, nullptr);
+		tree.setProperty("category", d.category, nullptr);
+		tree.setProperty("manufacturerName", d.manufacturerName, nullptr);
+		tree.setProperty("version", d.version, nullptr);
+		tree.setProperty("fileOrIdentifier", d.fileOrIdentifier, nullptr);
+		tree.setProperty("uid", d.uid, nullptr);
+		tree.setProperty("isInstrument", d.isInstrument, nullptr);
+		tree.setProperty("numInputChannels", d.numInputChannels, nullptr);
+		tree.setProperty("numOutputChannels", d.numOutputChannels, nullptr);
+		return tree;
+	}
+
+	PluginDescription treeToDescription(const ValueTree& tree)
+	{
+		PluginDescription d;
+		d.name = tree["name"];
+		d.descriptiveName = tree["descriptiveName"];
+		d.pluginFormatName = tree["pluginFormatName"];
+		d.category = tree["category"];
+		d.manufacturerName = tree["manufacturerName"];
+		d.version = tree["version"];
+		d.fileOrIdentifier = tree["fileOrIdentifier"];
+		d.uid = tree["uid"];
+		d.isInstrument = tree["isInstrument"];
+		d.numInputChannels = tree["numInputChannels"];
+		d.numOutputChannels = tree["numOutputChannels"];
+		return d;
+	}
+
+	MemoryBlock toMemoryBlock(const ValueTree& tree)
+	{
+		MemoryOutputStream out;
+		tree.writeToStream(out);
+		return out.getMemoryBlock();
+	}
+
+	File getSharedMemoryFolder()
+	{
+		File shm("/dev/shm");
+		return shm.isDirectory() ? shm : File::getSpecialLocation(File::tempDirectory);
+	}
+}
+
+//==============================================================================
+class SandboxedProcessor::SharedMemory
+{
+public:
+	SharedMemory(const File& fileToUse, int maxBlockSizeToUse, bool createFile)
+		: file(fileToUse), maxBlockSize(maxBlockSizeToUse), ownsFile(createFile)
+	{
+		if (ownsFile)
+		{
+			file.deleteFile();
+			FileOutputStream out(file);
+			out.writeRepeatedByte(0, getTotalBytes(maxBlockSize));
+		}
+
+		mapped.reset(new MemoryMappedFile(file, MemoryMappedFile::readWrite));
+
+		if (isValid() && ownsFile)
+		{
+			header().maxBlockSize = maxBlockSize;
+			header().numChannels = maxChannels;
+		}
+	}
+
+	~SharedMemory()
+	{
+		mapped = nullptr;
+		if (ownsFile)
+			file.deleteFile();
+	}
+
+	bool isValid() const noexcept
+	{
+		return mapped != nullptr && mapped->getData() != nullptr && mapped->getSize() >= getTotalBytes(maxBlockSize);
+	}
+
+	const File& getFile() const noexcept { return file; }
+	int getMaxBlockSize() const noexcept { return maxBlockSize; }
+
+	SharedHeader& header() noexcept { return *reinterpret_cast<SharedHeader*>(base()); }
+	SlotHeader& slot(uint32 seq) noexcept { return *reinterpret_cast<SlotHeader*>(slotBase(seq)); }
+
+	float* channel(uint32 seq, int ch) noexcept
+	{
+		return reinterpret_cast<float*>(slotBase(seq) + headerBytes) + ch * maxBlockSize;
+	}
+
+	uint8* midi(uint32 seq) noexcept
+	{
+		return slotBase(seq) + headerBytes + sizeof(float) * (size_t)(maxChannels * maxBlockSize);
+	}
+
+	//==============================================================================
+	void writeMidi(uint32 seq, const MidiBuffer& buffer) noexcept
+	{
+		auto* dest = midi(seq);
+		int numBytes = 0;
+
+		MidiBuffer::Iterator it(buffer);
+		const uint8* data;
+		int size, pos;
+
+		while (it.getNextEvent(data, size, pos))
+		{
+			const auto padded = (size + 3) & ~3;
+			if (numBytes + 8 + padded > midiBytesPerSlot)
+				break;
+
+			const int32 eventHeader[] = { pos, size };
+			memcpy(dest + numBytes, eventHeader, sizeof(eventHeader));
+			memcpy(dest + numBytes + 8, data, (size_t)size);
+			numBytes += 8 + padded;
+		}
+
+		slot(seq).numMidiBytes = numBytes;
+	}
+
+	void readMidi(uint32 seq, MidiBuffer& buffer) noexcept
+	{
+		const auto* src = midi(seq);
+		const auto numBytes = jmin((int)slot(seq).numMidiBytes, midiBytesPerSlot);
+
+		for (int offset = 0; offset + 8 <= numBytes;)
+		{
+			int32 eventHeader[2];
+			memcpy(eventHeader, src + offset, sizeof(eventHeader));
+
+			const auto size = (int)eventHeader[1];
+			if (size <= 0 || offset + 8 + size > numBytes)
+				break;
+
+			buffer.addEvent(src + offset + 8, size, eventHeader[0]);
+			offset += 8 + ((size + 3) & ~3);
+		}
+	}
+
+private:
+	uint8* base() noexcept { return static_cast<uint8*>(mapped->getData()); }
+	uint8* slotBase(uint32 seq) noexcept { return base() + headerBytes + (seq % numSlots) * getSlotBytes(maxBlockSize); }
+
+	File file;
+	const int maxBlockSize;
+	const bool ownsFile;
+	std::unique_ptr<MemoryMappedFile> mapped;
+
+	JUCE_DECLARE_NON_COPYABLE(SharedMemory)
+};
+
+//==============================================================================
+class SandboxedProcessor::Connection : public ChildProcessMaster
+{
+public:
+	Connection(SandboxedProcessor& o) : owner(o) {}
+
+	void handleMessageFromSlave(const MemoryBlock& data) override
+	{
+		owner.handleMessage(ValueTree::readFromData(data.getData(), data.getSize()));
+	}
+
+	void handleConnectionLost() override
+	{
+		connected = false;
+	}
+
+	std::atomic<bool> connected{ false };
+
+private:
+	SandboxedProcessor& owner;
+};
+
+//==============================================================================
+class SandboxedProcessor::Bridge : public ChildProcessSlave,
+                                   private Thread
+{
+public:
+	Bridge() : Thread("MicroChromo Bridge")
+	{
+		formatManager.addDefaultFormats();
+	}
+
+	~Bridge() override
+	{
+		stopThread(2000);
+		plugin = nullptr;
+	}
+
+	void handleMessageFromMaster(const MemoryBlock& data) override
+	{
+		// Plugins expect to be created and prepared on the message thread.
+		auto message = ValueTree::readFromData(data.getData(), data.getSize());
+		MessageManager::callAsync([this, message] { handleMessage(message); });
+	}
+
+	void handleConnectionLost() override
+	{
+		MessageManager::callAsync([] { JUCEApplicationBase::quit(); });
+	}
+
+private:
+	void handleMessage(const ValueTree& message)
+	{
+		if (message.hasType("load"))
+		{
+			String error;
+			plugin = formatManager.createPluginInstance(treeToDescription(message.getChild(0)), 44100.0, 512, error);
+
+			ValueTree reply("loaded");
+			reply.setProperty("error", plugin == nullptr ? error : String(), nullptr);
+			sendMessageToMaster(toMemoryBlock(reply));
+		}
+		else if (message.hasType("prepare") && plugin != nullptr)
+		{
+			stopThread(2000);
+
+			const double sampleRate = message["sampleRate"];
+			const int blockSize = message["blockSize"];
+			sharedMemory.reset(new SharedMemory(File(message["file"].toString()), blockSize, false));
+
+			if (!sharedMemory->isValid())
+				return;
+
+			plugin->setRateAndBufferSizeDetails(sampleRate, blockSize);
+			plugin->prepareToPlay(sampleRate, blockSize);
+			midiBuffer.ensureSize((size_t)midiBytesPerSlot);
+
+			auto& header = sharedMemory->header();
+			lastSeq = header.requestSeq.load();
+			header.latencySamples = plugin->getLatencySamples();
+			header.ready = 1;
+			startThread(9);
+
+			ValueTree reply("prepared");
+			reply.setProperty("latency", plugin->getLatencySamples(), nullptr);
+			sendMessageToMaster(toMemoryBlock(reply));
+		}
+		else if (message.hasType("release") && plugin != nullptr)
+		{
+			stopThread(2000);
+			plugin->releaseResources();
+		}
+		else if (message.hasType("getState") && plugin != nullptr)
+		{
+			MemoryBlock state;
+			plugin->getStateInformation(state);
+
+			ValueTree reply("state");
+			reply.setProperty("data", state.toBase64Encoding(), nullptr);
+			sendMessageToMaster(toMemoryBlock(reply));
+		}
+		else if (message.hasType("setState") && plugin != nullptr)
+		{
+			MemoryBlock state;
+			if (state.fromBase64Encoding(message["data"].toString()))
+				plugin->setStateInformation(state.getData(), (int)state.getSize());
+		}
+	}
+
+	void run() override
+	{
+		auto& header = sharedMemory->header();
+		const auto numChannels = jmin(maxChannels, jmax(plugin->getTotalNumInputChannels(), plugin->getTotalNumOutputChannels()));
+		float* channels[maxChannels];
+
+		while (!threadShouldExit())
+		{
+			const auto seq = waitForChange(header.requestSeq, lastSeq, 100.0);
+			if (seq == lastSeq)
+				continue;
+
+			lastSeq = seq;
+			const auto numSamples = jmin((int)sharedMemory->slot(seq).numSamples, sharedMemory->getMaxBlockSize());
+
+			for (int ch = 0; ch < numChannels; ++ch)
+				channels[ch] = sharedMemory->channel(seq, ch);
+
+			AudioBuffer<float> buffer(channels, numChannels, numSamples);
+			midiBuffer.clear();
+			sharedMemory->readMidi(seq, midiBuffer);
+
+			plugin->processBlock(buffer, midiBuffer);
+
+			header.latencySamples = plugin->getLatencySamples();
+			header.responseSeq.store(seq, std::memory_order_release);
+			wakeWaiters(header.responseSeq);
+		}
+	}
+
+	AudioPluginFormatManager formatManager;
+	std::unique_ptr<AudioPluginInstance> plugin;
+	std::unique_ptr<SharedMemory> sharedMemory;
+	MidiBuffer midiBuffer;
+	uint32 lastSeq = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(Bridge)
+};
+
+std::unique_ptr<ChildProcessSlave> SandboxedProcessor::createBridge(const String& commandLine)
+{
+	auto bridge = std::make_unique<Bridge>();
+
+	if (!bridge->initialiseFromCommandLine(commandLine, commandLineUid))
+		return nullptr;
+
+	return bridge;
+}
+
+//==============================================================================
+SandboxedProcessor::SandboxedProcessor(const PluginDescription& desc, const File& bridgeExecutable)
+	: AudioProcessor(BusesProperties().withOutput("Output", AudioChannelSet::stereo(), true)),
+	  description(desc)
+{
+	connection.reset(new Connection(*this));
+
+	if (connection->launchSlaveProcess(bridgeExecutable, commandLineUid, 0, 0))
+	{
+		connection->connected = true;
+
+		ValueTree message("load");
+		message.appendChild(descriptionToTree(description), nullptr);
+		sendMessage(message);
+	}
+	else
+	{
+		const ScopedLock sl(messageLock);
+		lastError = "Could not launch " + bridgeExecutable.getFullPathName();
+	}
+}
+
+SandboxedProcessor::~SandboxedProcessor()
+{
+	// Kills the bridge before its shared memory goes away.
+	connection = nullptr;
+	sharedMemory = nullptr;
+}
+
+File SandboxedProcessor::getDefaultBridgeExecutable()
+{
+	// The standalone build doubles as the bridge, installed next to the plugin.
+	auto folder = File::getSpecialLocation(File::currentApplicationFile).getParentDirectory();
+
+   #if JUCE_MAC
+	return folder.getChildFile("MicroChromo.app/Contents/MacOS/MicroChromo");
+   #elif JUCE_WINDOWS
+	return folder.getChildFile("MicroChromo.exe");
+   #else
+	return folder.getChildFile("MicroChromo");
+   #endif
+}
+
+bool SandboxedProcessor::isConnected() const noexcept
+{
+	return connection != nullptr && connection->connected.load();
+}
+
+String SandboxedProcessor::getLastError() const
+{
+	const ScopedLock sl(messageLock);
+	return lastError;
+}
+
+void SandboxedProcessor::sendMessage(const ValueTree& message)
+{
+	if (isConnected())
+		connection->sendMessageToSlave(toMemoryBlock(message));
+}
+
+void SandboxedProcessor::handleMessage(const ValueTree& message)
+{
+	if (message.hasType("loaded"))
+	{
+		const ScopedLock sl(messageLock);
+		lastError = message["error"].toString();
+	}
+	else if (message.hasType("prepared"))
+	{
+		setLatencySamples(message["latency"]);
+	}
+	else if (message.hasType("state"))
+	{
+		{
+			const ScopedLock sl(messageLock);
+			receivedState.reset();
+			receivedState.fromBase64Encoding(message["data"].toString());
+		}
+		stateReceived.signal();
+	}
+}
+
+//==============================================================================
+void SandboxedProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+	auto file = getSharedMemoryFolder().getNonexistentChildFile("MicroChromo_" + String::toHexString(Random::getSystemRandom().nextInt64()), ".shm", false);
+
+	sharedMemory.reset(new SharedMemory(file, samplesPerBlock, true));
+	requestCounter = 0;
+	lastRoundTripMicros = 0.0;
+	maxRoundTripMicros = 0.0;
+	numMissedBlocks = 0;
+
+	if (!sharedMemory->isValid())
+		return;
+
+	ValueTree message("prepare");
+	message.setProperty("file", file.getFullPathName(), nullptr);
+	message.setProperty("sampleRate", sampleRate, nullptr);
+	message.setProperty("blockSize", samplesPerBlock, nullptr);
+	sendMessage(message);
+}
+
+void SandboxedProcessor::releaseResources()
+{
+	sendMessage(ValueTree("release"));
+}
+
+void SandboxedProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+{
+	const auto numSamples = buffer.getNumSamples();
+	auto* shm = sharedMemory.get();
+
+	if (shm == nullptr || !shm->isValid() || !isConnected()
+		|| shm->header().ready.load() == 0 || numSamples > shm->getMaxBlockSize())
+	{
+		buffer.clear();
+		return;
+	}
+
+	auto& header = shm->header();
+
+	// There are two slots, so the next request goes where the one before
+	// the last did. A bridge that has not answered that one yet may still
+	// be reading it, and the block is given up instead.
+	if (requestCounter - header.responseSeq.load(std::memory_order_acquire) > 1)
+	{
+		numMissedBlocks.fetch_add(1);
+		buffer.clear();
+		return;
+	}
+
+	const auto seq = ++requestCounter;
+	const auto numChannels = jmin(buffer.getNumChannels(), maxChannels);
+
+	shm->slot(seq).numSamples = numSamples;
+	for (int ch = 0; ch < maxChannels; ++ch)
+	{
+		if (ch < numChannels)
+			FloatVectorOperations::copy(shm->channel(seq, ch), buffer.getReadPointer(ch), numSamples);
+		else
+			FloatVectorOperations::clear(shm->channel(seq, ch), numSamples);
+	}
+	shm->writeMidi(seq, midiMessages);
+
+	const auto startTicks = Time::getHighResolutionTicks();
+	header.requestSeq.store(seq, std::memory_order_release);
+	wakeWaiters(header.requestSeq);
+
+	// Give up after half a block; a stalled bridge must not stall the host.
+	const auto timeoutMs = jmax(1.0, 500.0 * numSamples / getSampleRate());
+	const auto deadline = Time::getMillisecondCounterHiRes() + timeoutMs;
+	auto response = header.responseSeq.load(std::memory_order_acquire);
+
+	while (response != seq)
+	{
+		const auto remaining = deadline - Time::getMillisecondCounterHiRes();
+		if (remaining <= 0.0)
+			break;
+		response = waitForChange(header.responseSeq, response, remaining);
+	}
+
+	if (response != seq)
+	{
+		numMissedBlocks.fetch_add(1);
+		buffer.clear();
+		return;
+	}
+
+	const auto micros = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+	lastRoundTripMicros = micros;
+	if (micros > maxRoundTripMicros.load())
+		maxRoundTripMicros = micros;
+
+	for (int ch = 0; ch < numChannels; ++ch)
+		buffer.copyFrom(ch, 0, shm->channel(seq, ch), numSamples);
+
+	const auto latency = (int)header.latencySamples.load();
+	if (latency != getLatencySamples())
+		setLatencySamples(latency);
+}
+
+//==============================================================================
+void SandboxedProcessor::getStateInformation(MemoryBlock& destData)
+{
+	stateReceived.reset();
+	sendMessage(ValueTree("getState"));
+
+	if (stateReceived.wait(2000))
+	{
+		const ScopedLock sl(messageLock);
+		destData = receivedState;
+	}
+}
+
+void SandboxedProcessor::requestState()
+{
+	sendMessage(ValueTree("getState"));
+}
+
+MemoryBlock SandboxedProcessor::getLastReceivedState() const
+{
+	const ScopedLock sl(messageLock);
+	return receivedState;
+}
+
+void SandboxedProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+	{
+		// What the plugin will hold once the bridge has passed it on.
+		const ScopedLock sl(messageLock);
+		receivedState.replaceWith(data, (size_t)sizeInBytes);
+	}
+
+	ValueTree message("setState");
+	message.setProperty("data", MemoryBlock(data, (size_t)sizeInBytes).toBase64Encoding(), nullptr);
+	sendMessage(message);
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    SandboxBridge.h
+    Created: 19 Oct 2026 3:36:18pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Runs a hosted backend inside a separate bridge process.
+
+    Control traffic (load, prepare, state) goes over the ChildProcessMaster
+    pipe. Audio and MIDI go through a memory-mapped file holding a two-slot
+    ring. Each block is written into the slot picked by its sequence number,
+    published by bumping a sequence word and answered the same way. On Linux
+    both sides block on those words with futexes after a short spin, so a
+    block needs no socket copies and no syscalls when the other side is
+    already waiting.
+
+    If the bridge misses a block, or dies, the instance outputs silence
+    instead of taking the session down with it.
+*/
+class SandboxedProcessor : public AudioProcessor
+{
+public:
+	SandboxedProcessor(const PluginDescription& description, const File& bridgeExecutable);
+	~SandboxedProcessor();
+
+	//==============================================================================
+	bool isConnected() const noexcept;
+	String getLastError() const;
+
+	/** Round trip of the last block and the worst seen since prepare, in microseconds. */
+	double getLastRoundTripMicros() const noexcept { return lastRoundTripMicros.load(); }
+	double getMaxRoundTripMicros() const noexcept { return maxRoundTripMicros.load(); }
+	int getNumMissedBlocks() const noexcept { return numMissedBlocks.load(); }
+
+	static File getDefaultBridgeExecutable();
+
+	/** Asks the bridge for the plugin's state without waiting for the answer. */
+	void requestState();
+
+	/** The state from the bridge's last answer, or the last one set; empty before either. */
+	MemoryBlock getLastReceivedState() const;
+
+	//==============================================================================
+	const String getName() const override { return description.name; }
+
+	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+	void releaseResources() override;
+	void processBlock(AudioBuffer<float>&, MidiBuffer&) override;
+
+	double getTailLengthSeconds() const override { return 0.0; }
+	bool acceptsMidi() const override { return true; }
+	bool producesMidi() const override { return false; }
+
+	AudioProcessorEditor* createEditor() override { return nullptr; }
+	bool hasEditor() const override { return false; }
+
+	int getNumPrograms() override { return 1; }
+	int getCurrentProgram() override { return 0; }
+	void setCurrentProgram(int) override {}
+	const String getProgramName(int) override { return {}; }
+	void changeProgramName(int, const String&) override {}
+
+	void getStateInformation(MemoryBlock&) override;
+	void setStateInformation(const void*, int) override;
+
+	//==============================================================================
+	/** Starts the bridge side if the command line asks for it, otherwise returns nullptr.
+	    The bridge quits the application once its master goes away.
+	*/
+	static std::unique_ptr<ChildProcessSlave> createBridge(const String& commandLine);
+
+	static const char* const commandLineUid;
+
+private:
+	//==============================================================================
+	class Connection;
+	class SharedMemory;
+	class Bridge;
+
+	void handleMessage(const ValueTree& message);
+	void sendMessage(const ValueTree& message);
+
+	PluginDescription description;
+	std::unique_ptr<Connection> connection;
+	std::unique_ptr<SharedMemory> sharedMemory;
+
+	uint32 requestCounter = 0;
+	std::atomic<double> lastRoundTripMicros{ 0.0 }, maxRoundTripMicros{ 0.0 };
+	std::atomic<int> numMissedBlocks{ 0 };
+
+	WaitableEvent stateReceived;
+	MemoryBlock receivedState;
+	String lastError;
+	CriticalSection messageLock;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SandboxedProcessor)
+};
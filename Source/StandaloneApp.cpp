@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    StandaloneApp.cpp
+    Created: 19 Oct 2026 4:58:02pm
+    Author:  hrukalive
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#if JucePlugin_Build_Standalone && JUCE_USE_CUSTOM_PLUGIN_STANDALONE_APP
+
+#include <juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h>
+#include "SandboxBridge.h"
+#include "BatchRenderer.h"
+#include "HeadlessServer.h"
+#include "Benchmarks.h"
+#include <iostream>
+
+//==============================================================================
+/**
+    Same as JUCE's stock standalone application, except that the executable
+    can also be launched as the out-of-process bridge for sandboxed backends,
+    as an offline batch renderer with --render, without a window as a
+    server taking commands over a local socket with --headless, or to run
+    the benchmarks with --benchmark.
+*/
+class MicroChromoStandaloneApp : public JUCEApplication
+{
+public:
+	MicroChromoStandaloneApp()
+	{
+		PluginHostType::jucePlugInClientCurrentWrapperType = AudioProcessor::wrapperType_Standalone;
+
+		PropertiesFile::Options options;
+		options.applicationName = getApplicationName();
+		options.filenameSuffix = ".settings";
+		options.osxLibrarySubFolder = "Application Support";
+	   #if JUCE_LINUX
+		options.folderName = "~/.config";
+	   #else
+		options.folderName = "";
+	   #endif
+
+		appProperties.setStorageParameters(options);
+	}
+
+	const String getApplicationName() override { return JucePlugin_Name; }
+	const String getApplicationVersion() override { return JucePlugin_VersionString; }
+	bool moreThanOneInstanceAllowed() override { return true; }
+	void anotherInstanceStarted(const String&) override {}
+
+	//==============================================================================
+	void initialise(const String& commandLine) override
+	{
+		if (commandLine.contains(SandboxedProcessor::commandLineUid))
+		{
+			bridge = SandboxedProcessor::createBridge(commandLine);
+			if (bridge == nullptr)
+				quit();
+			return;
+		}
+
+		if (commandLine.contains(BatchRenderer::commandLineFlag))
+		{
+			// Rendering runs off the message thread, which stays free to set
+			// up the processors.
+			renderThread.reset(new RenderThread(commandLine, BatchRenderer::runFromCommandLine));
+			renderThread->startThread();
+			return;
+		}
+
+		if (commandLine.contains(Benchmarks::commandLineFlag))
+		{
+			renderThread.reset(new RenderThread(commandLine, Benchmarks::runFromCommandLine));
+			renderThread->startThread();
+			return;
+		}
+
+		if (commandLine.contains(HeadlessServer::commandLineFlag))
+		{
+			headless.reset(new HeadlessServer(commandLine));
+
+			String error;
+			if (!headless->start(error))
+			{
+				std::cerr << error << std::endl;
+				setApplicationReturnValue(1);
+				quit();
+			}
+			return;
+		}
+
+		mainWindow.reset(new StandaloneFilterWindow(getApplicationName(),
+			LookAndFeel::getDefaultLookAndFeel().findColour(ResizableWindow::backgroundColourId),
+			appProperties.getUserSettings(), false, {}, nullptr, {}, false));
+
+		mainWindow->setVisible(true);
+	}
+
+	void shutdown() override
+	{
+		renderThread = nullptr;
+		headless = nullptr;
+		mainWindow = nullptr;
+		bridge = nullptr;
+		appProperties.saveIfNeeded();
+	}
+
+	void systemRequestedQuit() override
+	{
+		if (mainWindow != nullptr)
+			mainWindow->pluginHolder->savePluginState();
+
+		if (ModalComponentManager::getInstance()->cancelAllModalComponents())
+		{
+			Timer::callAfterDelay(100, []()
+			{
+				if (auto app = JUCEApplicationBase::getInstance())
+					app->systemRequestedQuit();
+			});
+		}
+		else
+		{
+			quit();
+		}
+	}
+
+private:
+	/** Runs a command-line mode to completion, then quits with its exit code. */
+	class RenderThread : public Thread
+	{
+	public:
+		using Mode = int (*)(const String& commandLine);
+
+		RenderThread(const String& args, Mode modeToRun) : Thread("MicroChromo Render"), commandLine(args), mode(modeToRun) {}
+		~RenderThread() override { stopThread(-1); }
+
+		void run() override
+		{
+			const auto exitCode = mode(commandLine);
+			MessageManager::callAsync([exitCode]
+			{
+				setApplicationReturnValue(exitCode);
+				quit();
+			});
+		}
+
+	private:
+		const String commandLine;
+		const Mode mode;
+	};
+
+	ApplicationProperties appProperties;
+	std::unique_ptr<StandaloneFilterWindow> mainWindow;
+	std::unique_ptr<ChildProcessSlave> bridge;
+	std::unique_ptr<RenderThread> renderThread;
+	std::unique_ptr<HeadlessServer> headless;
+};
+
+JUCE_CREATE_APPLICATION_DEFINE(MicroChromoStandaloneApp)
+
+#endif